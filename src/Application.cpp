@@ -45,10 +45,13 @@
 #endif // !_WIN32
 
 // STL
+#include <vector>
 #include <iostream>
+#include <fstream>
 
 // System
 #include <cstdlib>
+#include <cstring>
 #ifdef DATA_DIR
 # include <unistd.h>
 #endif // DATA_DIR
@@ -64,6 +67,16 @@
 #include "Cube.h"
 #include "Circuit.h"
 #include "Vehicle.h"
+#include "Pilot.h"
+#include "Race.h"
+#include "ThreadPool.h"
+#include "Replay.h"
+#include "History.h"
+#include "Server.h"
+#include "Client.h"
+#include "LapSplits.h"
+#include "RacingLine.h"
+#include "LineOverlay.h"
 #include "DepthOfField.h"
 #include "Application.h"
 
@@ -76,9 +89,38 @@ namespace Podz {
 
 Application *Application::instance = 0;
 
-Application::Application()
-    : fullScreen(false)
+// Rewinding: a snapshot every quarter of a second, for the last minute
+static const int SNAPSHOT_RATE = 4;
+static const int REWIND_SECONDS = 60;
+
+Application::Application(int rate, int opponents,
+			 const char *const recordFile,
+			 const char *const playFile,
+			 const char *const server)
+    : replay(0), record(0), history(0), client(0), splits(0),
+      racingLine(0), fullScreen(false)
 {
+    // Replay files are relative to the current directory, not the data one
+    if (playFile != 0) {
+	replay = new Replay;
+	if (!replay->Load(playFile)) {
+	    std::cerr << "Error: could not load replay '" << playFile << "' ("
+		      << Replay::GetErrorString(replay->GetError()) << ")."
+		      << std::endl;
+	    std::exit(3);
+	}
+	rate = replay->GetRate();
+	opponents = replay->GetOpponents();
+    } else if (recordFile != 0) {
+	record = new std::ofstream(recordFile,
+				   std::ios::out | std::ios::binary);
+	if (!record->is_open()) {
+	    std::cerr << "Error: could not create replay '" << recordFile
+		      << "'." << std::endl;
+	    std::exit(3);
+	}
+    }
+
     if (
 #ifdef DATA_DIR
 	chdir(DATA_DIR) != 0 &&
@@ -90,23 +132,80 @@ Application::Application()
 
     display = new Display;
 
-    Circuit *const circuit = new Circuit("level.txt");
+    pool = new ThreadPool;
+    Circuit *const circuit = new Circuit("level.txt", pool);
     if (!circuit->IsLoaded()) {
 	std::cerr << "Error: could not load level." << std::endl;
 	std::exit(2);
     }
 
+    unsigned levelHash = 0;
+    if (replay != 0 || record != 0 || server != 0)
+	Replay::HashLevel("level.txt", levelHash);
+    if (replay != 0 && replay->GetLevelHash() != levelHash) {
+	std::cerr << "Error: replay recorded on another level." << std::endl;
+	std::exit(3);
+    }
+    if (record != 0) {
+	replay = new Replay;
+	replay->Start(rate, levelHash, opponents);
+    }
+
+    // The server tells which pods are around the player, and where
+    if (server != 0) {
+	client = new Client(*circuit, levelHash, rate);
+	if (!client->Connect(server)) {
+	    std::cerr << "Error: could not connect to '" << server << "'."
+		      << std::endl;
+	    std::exit(4);
+	}
+	opponents = Server::MAX_VISIBLE - 1;
+    }
+
+    // Without a racing line, the opponents keep to the centre line
+    racingLine = new RacingLine(*circuit);
+    const bool overlay =
+	racingLine->Load(RacingLine::GetFileName("level.txt").c_str());
+
     Vehicle *const vehicle = new Vehicle(*circuit);
     Cube *const cube = new Cube(1000.f);
 
-    keyboard = new Keyboard(*display, *vehicle);
-    timer = new Timer(10, *keyboard);
+    // The player first, then the opponents
+    race = new Race(*circuit, pool);
+    race->AddPod(*vehicle);
+    std::vector<Vehicle *> vehicles(1, vehicle);
+    for (int i = 0; i < opponents; ++i) {
+	Vehicle *const opponent = new Vehicle(*circuit, false);
+	race->AddPod(*opponent, client == 0 ?
+		     Pilot::CreateOpponent(*circuit, i, racingLine) : 0);
+	vehicles.push_back(opponent);
+    }
+
+    if (client == 0) {
+	const int interval = rate > SNAPSHOT_RATE ? rate / SNAPSHOT_RATE : 1;
+	history = new History(*race, 1.f / static_cast<float>(rate),
+			      REWIND_SECONDS * rate / interval, interval);
+    }
+
+    keyboard = new Keyboard(*display, *race);
+    keyboard->SetHistory(history);
+    keyboard->SetClient(client);
+    splits = new LapSplits(circuit->GetTotalLength());
+    keyboard->SetSplits(splits);
+    vehicle->SetSplits(splits);
+    timer = new Timer(rate, *keyboard);
     keyboard->SetTimer(timer);
-    vehicle->SetTimer(timer);
+    if (replay != 0)
+	keyboard->SetReplay(replay, record == 0);
 
     display->AddObject(cube);
     display->AddObject(circuit);
-    display->AddObject(vehicle);
+    if (overlay)
+	display->AddObject(new LineOverlay(*circuit, *racingLine));
+    for (std::vector<Vehicle *>::size_type i = 0; i < vehicles.size(); ++i) {
+	vehicles[i]->SetTimer(timer);
+	display->AddObject(vehicles[i]);
+    }
     display->AddObject(timer);
 
     display->AddPostProcess(new DepthOfField(*display, -2.f, 2.f, 5.f, 30.f));
@@ -114,6 +213,9 @@ Application::Application()
     // Ensure resources get freed
     instance = this;
     std::atexit(OnExit);
+
+    if (playFile != 0 || client != 0)
+	timer->Start();
 }
 
 Application::~Application()
@@ -122,6 +224,19 @@ Application::~Application()
     delete display;
     delete keyboard;
     //delete timer; -- done by display
+    delete history;
+    delete client;
+    delete splits;
+    delete racingLine;
+    delete race;
+    delete pool;
+
+    if (record != 0) {
+	if (!replay->Save(*record))
+	    std::cerr << "Error: could not save replay." << std::endl;
+	delete record;
+    }
+    delete replay;
 }
 
 void Application::DoToogleFullScreen()
@@ -156,7 +271,66 @@ extern "C" int main(int argc, char **argv)
 {
     // Initialization
     glutInit(&argc, argv);
-    new Podz::Application;
+
+    // Simulation rate: "-r <rate>" or "--rate <rate>", in ticks per second;
+    // number of opponents: "-o <number>" or "--opponents <number>"; replay
+    // recording: "-w <file>" or "--record <file>"; replay playback: "-p
+    // <file>" or "--play <file>"; multiplayer: "-c <host[:port]>" or
+    // "--connect <host[:port]>"
+    int rate = Podz::Application::DEFAULT_RATE;
+    int opponents = Podz::Application::DEFAULT_OPPONENTS;
+    const char *recordFile = 0, *playFile = 0, *server = 0;
+    for (int i = 1; i < argc; ++i) {
+	if ((std::strcmp(argv[i], "-r") == 0 ||
+	     std::strcmp(argv[i], "--rate") == 0) && i + 1 < argc)
+	    rate = std::atoi(argv[++i]);
+	else if ((std::strcmp(argv[i], "-o") == 0 ||
+		  std::strcmp(argv[i], "--opponents") == 0) && i + 1 < argc)
+	    opponents = std::atoi(argv[++i]);
+	else if ((std::strcmp(argv[i], "-w") == 0 ||
+		  std::strcmp(argv[i], "--record") == 0) && i + 1 < argc)
+	    recordFile = argv[++i];
+	else if ((std::strcmp(argv[i], "-p") == 0 ||
+		  std::strcmp(argv[i], "--play") == 0) && i + 1 < argc)
+	    playFile = argv[++i];
+	else if ((std::strcmp(argv[i], "-c") == 0 ||
+		  std::strcmp(argv[i], "--connect") == 0) && i + 1 < argc)
+	    server = argv[++i];
+	else {
+	    std::cerr << "Usage: " << argv[0] << " [-r RATE] [-o OPPONENTS]"
+			 " [-w REPLAY | -p REPLAY | -c SERVER]" << std::endl;
+	    return EXIT_FAILURE;
+	}
+    }
+    if (rate < Podz::Application::MIN_RATE ||
+	rate > Podz::Application::MAX_RATE) {
+	std::cerr << "Error: rate must be between "
+		  << Podz::Application::MIN_RATE << " and "
+		  << Podz::Application::MAX_RATE << " ticks per second."
+		  << std::endl;
+	return EXIT_FAILURE;
+    }
+
+    if (opponents < 0 || opponents > Podz::Application::MAX_OPPONENTS) {
+	std::cerr << "Error: there can be at most "
+		  << Podz::Application::MAX_OPPONENTS << " opponents."
+		  << std::endl;
+	return EXIT_FAILURE;
+    }
+
+    if (recordFile != 0 && playFile != 0) {
+	std::cerr << "Error: cannot both record and play a replay."
+		  << std::endl;
+	return EXIT_FAILURE;
+    }
+
+    if (server != 0 && (recordFile != 0 || playFile != 0)) {
+	std::cerr << "Error: races on a server cannot be replayed."
+		  << std::endl;
+	return EXIT_FAILURE;
+    }
+
+    new Podz::Application(rate, opponents, recordFile, playFile, server);
 
     // Main loop
     glutMainLoop();
@@ -32,18 +32,44 @@
 #ifndef PODZ_APPLICATION_H
 #define PODZ_APPLICATION_H
 
+#include <iosfwd>
+
+#include "Replay.h"
+
 namespace Podz {
 
 class Display;
 class Keyboard;
 class Timer;
+class ThreadPool;
+class Race;
+class History;
+class Client;
+class LapSplits;
+class RacingLine;
 
 class Application
 {
 public:
-    Application();
+    // With a record file, the player inputs are saved to it on exit; with a
+    // play file, they are played back instead of read from the keyboard,
+    // at the rate and with the opponents of the recording; with a server
+    // address, the race is the one it runs, with the pods around the player
+    Application(int rate = DEFAULT_RATE, int opponents = DEFAULT_OPPONENTS,
+		const char *const recordFile = 0,
+		const char *const playFile = 0,
+		const char *const server = 0);
     ~Application();
 
+    // Simulation rate bounds, in ticks per second
+    enum {
+	DEFAULT_RATE = 100,
+	MIN_RATE = Replay::MIN_RATE, MAX_RATE = Replay::MAX_RATE
+    };
+
+    // Number of computer-driven pods
+    enum { DEFAULT_OPPONENTS = 5, MAX_OPPONENTS = Replay::MAX_OPPONENTS };
+
     void DoToogleFullScreen();
 
     static void ToogleFullScreen() { instance->DoToogleFullScreen(); };
@@ -53,6 +79,14 @@ private:
     Display *display;
     Keyboard *keyboard;
     Timer *timer;
+    ThreadPool *pool;
+    Race *race;
+    Replay *replay;
+    std::ofstream *record;
+    History *history;
+    Client *client;
+    LapSplits *splits;
+    RacingLine *racingLine;
 
     bool fullScreen;
 
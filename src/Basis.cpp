@@ -34,125 +34,73 @@
 # include <config.h>
 #endif // HAVE_CONFIG_H
 
-// OpenGL
-#define PODZ_USE_GL
-#include "OpenGL.h"
-
 // This module
 #include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
 #include "Basis.h"
 
 namespace Podz {
 
 Basis::Basis()
-    : origin(0.f, 0.f, 0.f), right(1.f, 0.f, 0.f),
-      up(0.f, 1.f, 0.f), backward(0.f, 0.f, 1.f)
+    : origin(0.f, 0.f, 0.f)
 {
-    Setup();
+    SetupRotation();
 }
 
 Basis::Basis(const Vector &vorigin, const Vector &direction,
 	     const Vector &vup)
-    : origin(vorigin), up(vup), backward(-direction)
+    : origin(vorigin)
 {
-    up.Normalize();
-    backward.Normalize();
-    right = (direction * up) % 1;
+    Vector frame[2] = { vup, -direction };
+    VectorBatch::Normalize(frame, 2);
+    backward = frame[1];
+    right = (direction * frame[0]) % 1;
     up = backward * right;
 
-    Setup();
+    SetupFrame();
 }
 
 Basis::Basis(const Vector &vorigin, const Vector &vright,
 	     const Vector &vup, const Vector &vbackward)
-    : origin(vorigin), right(vright), up(vup), backward(vbackward)
-{
-    right.Normalize();
-    up.Normalize();
-    backward.Normalize();
-
-    Setup();
-}
-
-void Basis::Setup()
+    : origin(vorigin)
 {
-    transform[0][0] = right.x;
-    transform[0][1] = up.x;
-    transform[0][2] = backward.x;
-    transform[0][3] = 0.f;
-    transform[1][0] = right.y;
-    transform[1][1] = up.y;
-    transform[1][2] = backward.y;
-    transform[1][3] = 0.f;
-    transform[2][0] = right.z;
-    transform[2][1] = up.z;
-    transform[2][2] = backward.z;
-    transform[2][3] = 0.f;
-    transform[3][0] = 0.f;
-    transform[3][1] = 0.f;
-    transform[3][2] = 0.f;
-    transform[3][3] = 1.f;
-
-    RevertMatrix(transform, invert);
-}
+    Vector frame[3] = { vright, vup, vbackward };
+    VectorBatch::Normalize(frame, 3);
+    right = frame[0];
+    up = frame[1];
+    backward = frame[2];
 
-Basis Basis::Merge(const Basis &other, const float coef) const
-{
-    if (coef < 0.f || coef > 1.f)
-	return Basis();
-    return Basis(origin   * (1.f - coef) + other.origin   * coef,
-		 right    * (1.f - coef) + other.right    * coef,
-		 up       * (1.f - coef) + other.up       * coef,
-		 backward * (1.f - coef) + other.backward * coef);
+    SetupFrame();
 }
 
-void Basis::Move() const
+Basis::Basis(const Vector &vorigin, const Quaternion &vrotation)
+    : origin(vorigin), rotation(vrotation)
 {
-    glTranslatef(origin.x, origin.y, origin.z);
-    glMultMatrixf(invert[0]);
+    SetupRotation();
 }
 
-void Basis::SetView() const
+// From the frame vectors, which must be orthonormal and right-handed: they
+// are then rebuilt from the rotation, for every basis to be exactly what
+// its rotation gives
+void Basis::SetupFrame()
 {
-    glMultMatrixf(transform[0]);
-    glTranslatef(-origin.x, -origin.y, -origin.z);
+    rotation = Quaternion::FromFrame(right, up, backward);
+    SetupRotation();
 }
 
-Vector Basis::Mult(const GLfloat matrix[4][4], const Vector &v)
+void Basis::SetupRotation()
 {
-    return Vector(
-	matrix[0][0] * v.x + matrix[0][1] * v.y + matrix[0][2] * v.z,
-	matrix[1][0] * v.x + matrix[1][1] * v.y + matrix[1][2] * v.z,
-	matrix[2][0] * v.x + matrix[2][1] * v.y + matrix[2][2] * v.z);
+    rotation.ToFrame(right, up, backward);
+    transform = Matrix(right, up, backward);
 }
 
-bool Basis::RevertMatrix(const GLfloat m[4][4], GLfloat result[4][4])
+Basis Basis::Merge(const Basis &other, const float coef) const
 {
-    GLfloat det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
-		- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
-		+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
-    if (det == 0.f)
-	return false;
-    det = 1.f / det;
-
-    result[0][0] = det * (m[1][1] * m[2][2] - m[1][2] * m[2][1]);
-    result[0][1] = det * (m[0][2] * m[2][1] - m[0][1] * m[2][2]);
-    result[0][2] = det * (m[0][1] * m[1][2] - m[0][2] * m[1][1]);
-    result[0][3] = 0.f;
-    result[1][0] = det * (m[1][2] * m[2][0] - m[1][0] * m[2][2]);
-    result[1][1] = det * (m[0][0] * m[2][2] - m[0][2] * m[2][0]);
-    result[1][2] = det * (m[0][2] * m[1][0] - m[0][0] * m[1][2]);
-    result[1][3] = 0.f;
-    result[2][0] = det * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
-    result[2][1] = det * (m[0][1] * m[2][0] - m[0][0] * m[2][1]);
-    result[2][2] = det * (m[0][0] * m[1][1] - m[0][1] * m[1][0]);
-    result[2][3] = 0.f;
-    result[3][0] = 0.f;
-    result[3][1] = 0.f;
-    result[3][2] = 0.f;
-    result[3][3] = 1.f;
-
-    return true;
+    if (coef < 0.f || coef > 1.f)
+	return Basis();
+    return Basis(origin * (1.f - coef) + other.origin * coef,
+		 Quaternion::Nlerp(rotation, other.rotation, coef));
 }
 
 } // namespace Podz
@@ -32,14 +32,16 @@
 #ifndef PODZ_BASIS_H
 #define PODZ_BASIS_H
 
-#define PODZ_USE_GL
-#include "OpenGL.h"
-
 #include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
 
 
 namespace Podz {
 
+// Orthonormal frame: its orientation is a unit quaternion, from which the
+// vectors and the transform matrix derive, and its inverse is the
+// transpose, applied on the fly as dot products with the vectors
 class Basis
 {
 public:
@@ -49,38 +51,38 @@ public:
     Basis(const Vector &vorigin, const Vector &direction, const Vector &vup);
     Basis(const Vector &vorigin, const Vector &vright,
 	  const Vector &vup, const Vector &vbackward);
+    Basis(const Vector &vorigin, const Quaternion &vrotation);
 
+    // Origins interpolated linearly, orientations by quaternion nlerp
     Basis Merge(const Basis &other, const float coef = .5f) const;
 
+    const Quaternion &GetRotation() const { return rotation; }
+
     Vector TransformVector(const Vector &v) const
-	{ return Mult(transform, v); }
+	{ return transform.Mult(v); }
     Vector RevertVector(const Vector &v) const
-	{ return Mult(invert, v); }
+	{ return Vector(right.DotProduct(v), up.DotProduct(v),
+			backward.DotProduct(v)); }
 
     Vector TransformPoint(const Vector &v) const
-	{ return Mult(transform, v) + origin; }
+	{ return transform.Mult(v) + origin; }
     Vector RevertPoint(const Vector &v) const
-	{ return Mult(invert, v - origin); }
+	{ return RevertVector(v - origin); }
 
     void Rotate(const float rx, const float ry, const float rz)
     {
 	right.Rotate(rx, ry, rz);
 	up.Rotate(rx, ry, rz);
 	backward.Rotate(rx, ry, rz);
+	SetupFrame();
     }
 
-    void Move() const;
-    void SetView() const;
-
 private:
-    GLfloat transform[4][4];
-    GLfloat invert[4][4];
-
-    void Setup();
+    Quaternion rotation;
+    Matrix transform;
 
-    static Vector Mult(const GLfloat matrix[4][4], const Vector &v);
-    public:
-    static bool RevertMatrix(const GLfloat m[4][4], GLfloat result[4][4]);
+    void SetupFrame();
+    void SetupRotation();
 };
 
 } // namespace Podz
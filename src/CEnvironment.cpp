@@ -0,0 +1,107 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/CEnvironment.cpp
+ * Description: Training Environment C Interface
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// This module
+#include "Track.h"
+#include "ThreadPool.h"
+#include "Environment.h"
+#include "CEnvironment.h"
+
+
+struct PodzEnvironment
+{
+    Podz::Track *track;
+    Podz::ThreadPool *pool;
+    Podz::Environment *environment;
+};
+
+extern "C" PodzEnvironment *podz_env_create(const char *level, int count,
+					    int rate, int max_ticks,
+					    int threads)
+{
+    if (count <= 0 || rate <= 0 || max_ticks < 0 || threads < 0)
+	return 0;
+
+    Podz::ThreadPool *const pool = new Podz::ThreadPool(threads);
+    Podz::Track *const track = new Podz::Track(level, pool);
+    if (!track->IsLoaded()) {
+	delete track;
+	delete pool;
+	return 0;
+    }
+
+    PodzEnvironment *const env = new PodzEnvironment;
+    env->track = track;
+    env->pool = pool;
+    env->environment = new Podz::Environment(*track, count, rate, max_ticks,
+					     env->pool);
+    return env;
+}
+
+extern "C" void podz_env_destroy(PodzEnvironment *env)
+{
+    if (env == 0)
+	return;
+
+    delete env->environment;
+    delete env->pool;
+    delete env->track;
+    delete env;
+}
+
+extern "C" int podz_env_count(const PodzEnvironment *env)
+{
+    return env->environment->GetCount();
+}
+
+extern "C" int podz_env_observation_size(void)
+{
+    return Podz::Environment::OBSERVATION_SIZE;
+}
+
+extern "C" void podz_env_reset(PodzEnvironment *env, float *observations)
+{
+    env->environment->Reset(observations);
+}
+
+extern "C" void podz_env_step(PodzEnvironment *env, const unsigned *actions,
+			      float *observations, float *rewards,
+			      unsigned char *dones)
+{
+    env->environment->Step(actions, observations, rewards, dones);
+}
+
+// End of File
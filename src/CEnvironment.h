@@ -0,0 +1,68 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/CEnvironment.h
+ * Description: Training Environment C Interface (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_CENVIRONMENT_H
+#define PODZ_CENVIRONMENT_H
+
+/*
+ * C interface to Podz::Environment, for use from other languages: see
+ * Environment.h for the meaning of actions, observations, rewards and ends.
+ * Arrays hold one entry (or podz_env_observation_size() floats) per
+ * episode.  This header is installed as <podz/CEnvironment.h>, and the
+ * functions are in the shared library libpodz-env.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct PodzEnvironment PodzEnvironment;
+
+/* Returns a null pointer if the level cannot be loaded; max_ticks = 0 for
+ * episodes without time limit, threads = 0 for one per processor */
+PodzEnvironment *podz_env_create(const char *level, int count, int rate,
+				 int max_ticks, int threads);
+void podz_env_destroy(PodzEnvironment *env);
+
+int podz_env_count(const PodzEnvironment *env);
+int podz_env_observation_size(void);
+
+void podz_env_reset(PodzEnvironment *env, float *observations);
+void podz_env_step(PodzEnvironment *env, const unsigned *actions,
+		   float *observations, float *rewards, unsigned char *dones);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* !PODZ_CENVIRONMENT_H */
+
+/* End of File */
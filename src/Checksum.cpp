@@ -0,0 +1,122 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Checksum.cpp
+ * Description: State Checksums
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cstring>
+
+// This module
+#include "Checksum.h"
+
+
+namespace Podz {
+
+static const unsigned PRIME1 = 2654435761u;
+static const unsigned PRIME2 = 2246822519u;
+static const unsigned PRIME3 = 3266489917u;
+static const unsigned PRIME4 = 668265263u;
+static const unsigned PRIME5 = 374761393u;
+
+static inline unsigned Rotate(const unsigned value, const int bits)
+{
+    return value << bits | value >> (32 - bits);
+}
+
+// Little-endian 32-bit word, whatever the platform
+static inline unsigned Read(const unsigned char *const bytes)
+{
+#ifdef WORDS_BIGENDIAN
+    return static_cast<unsigned>(bytes[0])
+	 | static_cast<unsigned>(bytes[1]) << 8
+	 | static_cast<unsigned>(bytes[2]) << 16
+	 | static_cast<unsigned>(bytes[3]) << 24;
+#else // !WORDS_BIGENDIAN
+    unsigned word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+#endif // !WORDS_BIGENDIAN
+}
+
+static inline unsigned Round(const unsigned acc, const unsigned input)
+{
+    return Rotate(acc + input * PRIME2, 13) * PRIME1;
+}
+
+unsigned Checksum::Compute(const void *const data, const std::size_t size,
+			   const unsigned seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    const unsigned char *const end = bytes + size;
+    unsigned hash;
+
+    if (size >= 16) {
+	unsigned v1 = seed + PRIME1 + PRIME2, v2 = seed + PRIME2;
+	unsigned v3 = seed, v4 = seed - PRIME1;
+	for (const unsigned char *const limit = end - 16; bytes <= limit;
+	     bytes += 16) {
+	    v1 = Round(v1, Read(bytes));
+	    v2 = Round(v2, Read(bytes + 4));
+	    v3 = Round(v3, Read(bytes + 8));
+	    v4 = Round(v4, Read(bytes + 12));
+	}
+	hash = Rotate(v1, 1) + Rotate(v2, 7) + Rotate(v3, 12)
+	     + Rotate(v4, 18);
+    } else
+	hash = seed + PRIME5;
+
+    hash += static_cast<unsigned>(size);
+    for (; bytes + 4 <= end; bytes += 4)
+	hash = Rotate(hash + Read(bytes) * PRIME3, 17) * PRIME4;
+    for (; bytes < end; ++bytes)
+	hash = Rotate(hash + *bytes * PRIME5, 11) * PRIME1;
+
+    hash ^= hash >> 15;
+    hash *= PRIME2;
+    hash ^= hash >> 13;
+    hash *= PRIME3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+unsigned Checksum::GetBits(const float value)
+{
+    unsigned bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace Podz
+
+// End of File
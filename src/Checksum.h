@@ -0,0 +1,55 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Checksum.h
+ * Description: State Checksums (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_CHECKSUM_H
+#define PODZ_CHECKSUM_H
+
+#include <cstddef>
+
+namespace Podz {
+
+class Checksum
+{
+public:
+    // xxHash (32-bit variant) of a block of memory, the same on every
+    // platform with 32-bit unsigned integers
+    static unsigned Compute(const void *const data, const std::size_t size,
+			    const unsigned seed = 0);
+
+    // Bits of a float, to hash exact values
+    static unsigned GetBits(const float value);
+};
+
+} // namespace Podz
+
+#endif // !PODZ_CHECKSUM_H
+
+// End of File
@@ -36,7 +36,6 @@
 
 // STL
 #include <vector>
-#include <fstream>
 
 // System
 #include <cmath>
@@ -48,130 +47,82 @@
 // This module
 #include "Object.h"
 #include "Vector.h"
+#include "Basis.h"
+#include "Matrix.h"
 #include "Texture.h"
+#include "Track.h"
 #include "Circuit.h"
 
 namespace Podz {
 
-static const float SEG_LENGTH = 2.f;
-static const float CIRC_WIDTH = 4.f;
-static const float BORDER_WIDTH = .3f, BORDER_HEIGHT = .8f;
+// Track length covered by the textures, which repeat along the track
+static const float TEXTURE_LENGTH = 2.f;
 
-Circuit::Circuit(const char *const filename)
-    : nb_segs(0), segments(0)
+Circuit::Circuit(const char *const filename, ThreadPool *const pool)
+    : Track(filename, pool)
 {
     static const char *const files[TEX_NUM] = { "circuit", "border" };
 
     for (int i = 0; i < TEX_NUM; ++i)
-	textures[i] = new Texture(files[i]);
-
-    std::ifstream file(filename);
-    if (!file.is_open())
-	return;
-
-    int nb_pts;
-    file >> nb_pts;
-
-    Point *ptTan = new Point[nb_pts + 2];
-
-    for (int i = 1; i <= nb_pts; ++i) {
-	file >> ptTan[i].point.x
-	     >> ptTan[i].point.y
-	     >> ptTan[i].point.z
-	     >> ptTan[i].normal.x
-	     >> ptTan[i].normal.y
-	     >> ptTan[i].normal.z;
-	ptTan[i].normal.Normalize();
-    }
-
-    if (!file.good()) {
-	delete[] ptTan;
-	nb_segs = 0;
-	return;
-    }
-
-    ptTan[nb_pts + 1].point = ptTan[1].point;
-    ptTan[nb_pts + 1].normal = ptTan[1].normal;
-    ptTan[0].point = ptTan[nb_pts].point;
-    ptTan[0].normal = ptTan[nb_pts].normal;
-
-    for (int i = 0; i < nb_pts; ++i)
-	ptTan[i + 1].tangent =
-	    (((ptTan[i + 1].point - ptTan[i].point) % 1) +
-	     ((ptTan[i + 2].point - ptTan[i + 1].point) % 1)) % 1;
-    ptTan[nb_pts + 1].tangent = ptTan[1].tangent;
-    ptTan[0].tangent = ptTan[nb_pts].tangent;
-
-    std::vector<Segment> frags;
-    totalLength = 0.f;
-    for (int i = 1; i <= nb_pts; ++i)
-	AddSegment(ptTan[i], ptTan[i + 1], frags);
-
-    delete[] ptTan;
-
-    nb_segs = static_cast<int>(frags.size());
-    segments = new Segment[nb_segs + 1];
-    for (int i = 0; i < nb_segs; ++i)
-	segments[i] = frags[i];
-    segments[nb_segs] = segments[0];
+	textures[i] = new Texture(files[i], true);
 }
 
 Circuit::~Circuit()
 {
     for (int i = 0; i < TEX_NUM; ++i)
 	delete textures[i];
-
-    if (segments != 0)
-	delete[] segments;
 }
 
 void Circuit::DisplayConst()
 {
     const int tex[3] = { TEX_BORDER, TEX_CIRCUIT, TEX_BORDER };
+    const float borderWidth = GetBorderWidth();
+    const float borderHeight = GetBorderHeight();
 
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     glColor3f(.3f, .3f, 1.f);
 
+    // Cross-sections, and normals of the borders facing inwards, at every
+    // segment start
+    std::vector<Basis> frames(nb_segs + 1);
+    std::vector<Vector> points(4 * (nb_segs + 1));
+    std::vector<Vector> borders(2 * (nb_segs + 1));
+    for (int i = 0; i <= nb_segs; ++i) {
+	const Basis &basis = frames[i] = GetFrame(i);
+	GetSection(i, &points[4 * i]);
+	borders[2 * i] = basis.up * borderWidth + basis.right * borderHeight;
+	borders[2 * i + 1] = basis.up * borderWidth
+			   - basis.right * borderHeight;
+    }
+    VectorBatch::NormalizeFast(&borders[0], 2 * (nb_segs + 1));
+
+    float along = 0.f;
     for (int i = 0; i < nb_segs; ++i) {
+	const float texStart = along / TEXTURE_LENGTH;
+	const float texEnd = texStart + segments[i].length / TEXTURE_LENGTH;
+	along = fmodf(along + segments[i].length, TEXTURE_LENGTH);
+
 	const Vector normals[2][3] = {
-	    {
-		(segments[i].basis.up * BORDER_WIDTH +
-		    segments[i].basis.right * BORDER_HEIGHT) % 1.f,
-		segments[i].basis.up,
-		(segments[i].basis.up * BORDER_WIDTH -
-		    segments[i].basis.right * BORDER_HEIGHT) % 1.f,
-	    }, {
-		(segments[i + 1].basis.up * BORDER_WIDTH +
-		    segments[i + 1].basis.right * BORDER_HEIGHT) % 1.f,
-		segments[i + 1].basis.up,
-		(segments[i + 1].basis.up * BORDER_WIDTH -
-		    segments[i + 1].basis.right * BORDER_HEIGHT) % 1.f,
-	    }
+	    { borders[2 * i], frames[i].up, borders[2 * i + 1] },
+	    { borders[2 * i + 2], frames[i + 1].up, borders[2 * i + 3] }
 	};
+	const Vector *const start = &points[4 * i], *const end = start + 4;
 
 	for (int j = 0; j < 3; ++j) {
 	    textures[tex[j]]->Select();
 	    glBegin(GL_QUADS);
 
 	    glNormal3f(normals[0][j].x, normals[0][j].y, normals[0][j].z);
-	    glTexCoord2f(0.f, 0.f);
-	    glVertex3f(segments[i].points[j].x,
-		       segments[i].points[j].y,
-		       segments[i].points[j].z);
-	    glTexCoord2f(0.f, 1.f);
-	    glVertex3f(segments[i].points[j + 1].x,
-		       segments[i].points[j + 1].y,
-		       segments[i].points[j + 1].z);
+	    glTexCoord2f(texStart, 0.f);
+	    glVertex3f(start[j].x, start[j].y, start[j].z);
+	    glTexCoord2f(texStart, 1.f);
+	    glVertex3f(start[j + 1].x, start[j + 1].y, start[j + 1].z);
 
 	    glNormal3f(normals[1][j].x, normals[1][j].y, normals[1][j].z);
-	    glTexCoord2f(1.f, 1.f);
-	    glVertex3f(segments[i + 1].points[j + 1].x,
-		       segments[i + 1].points[j + 1].y,
-		       segments[i + 1].points[j + 1].z);
-	    glTexCoord2f(1.f, 0.f);
-	    glVertex3f(segments[i + 1].points[j].x,
-		       segments[i + 1].points[j].y,
-		       segments[i + 1].points[j].z);
+	    glTexCoord2f(texEnd, 1.f);
+	    glVertex3f(end[j + 1].x, end[j + 1].y, end[j + 1].z);
+	    glTexCoord2f(texEnd, 0.f);
+	    glVertex3f(end[j].x, end[j].y, end[j].z);
 
 	    glEnd();
 	}
@@ -179,83 +130,6 @@ void Circuit::DisplayConst()
     glDisable(GL_TEXTURE_2D);
 }
 
-Basis Circuit::GetBasis(float position) const
-{
-    float length;
-    int cursor = 0;
-
-    while (position < 0.f)
-	position += totalLength;
-    while (position >= totalLength)
-	position -= totalLength;
-
-    while (position >= (length = segments[cursor].length)) {
-	position -= length;
-	if (++cursor == nb_segs)
-	    cursor = 0;
-    }
-
-    return segments[cursor].basis.Merge(segments[cursor + 1].basis,
-					position / length);
-}
-
-float Circuit::GetWidth(float position) const
-{
-    float length;
-    int cursor = 0;
-
-    while (position < 0.f)
-	position += totalLength;
-    while (position >= totalLength)
-	position -= totalLength;
-
-    while (position >= (length = segments[cursor].length)) {
-	position -= length;
-	if (++cursor == nb_segs)
-	    cursor = 0;
-    }
-
-    return segments[cursor].width * (1.f - position) +
-	   segments[cursor + 1].width * position;
-}
-
-float Circuit::GetBorderSlope()
-{
-    return BORDER_WIDTH / BORDER_HEIGHT;
-}
-
-void Circuit::AddSegment(const Point &start, const Point &end,
-			 std::vector<Segment> &segs)
-{
-    const Vector diff = end.point - start.point;
-    const float len = diff.Length(), len_4 = len / 4.f;
-
-    if (len > SEG_LENGTH) {
-	Point middle = {
-	    ((start.point + start.tangent * len_4) +
-		    (end.point - end.tangent * len_4)) / 2.f,
-	    (end.normal + start.normal) * .5f,
-	    diff / len
-	};
-
-	AddSegment(start, middle, segs);
-	AddSegment(middle, end, segs);
-    } else {
-	const Vector right = (diff * start.normal) % 1,
-	pt2 = start.point - right * (CIRC_WIDTH * .5f),
-	pt3 = start.point + right * (CIRC_WIDTH * .5f),
-	pt1 = pt2 - right * BORDER_WIDTH + start.normal * BORDER_HEIGHT,
-	pt4 = pt3 + right * BORDER_WIDTH + start.normal * BORDER_HEIGHT;
-
-	Segment newseg = {
-	    { pt1, pt2, pt3, pt4 }, len, CIRC_WIDTH,
-	    Basis(start.point, diff, start.normal)
-	};
-	segs.push_back(newseg);
-	totalLength += len;
-    }
-}
-
 } // namespace Podz
 
 // End of File
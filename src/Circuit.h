@@ -32,54 +32,27 @@
 #ifndef PODZ_CIRCUIT_H
 #define PODZ_CIRCUIT_H
 
-// STL
-#include <vector>
-
 // This module
 #include "Object.h"
-#include "Vector.h"
-#include "Basis.h"
+#include "Track.h"
 
 
 namespace Podz {
 
 class Texture;
+class ThreadPool;
 
-class Circuit : public Object
+class Circuit : public Object, public Track
 {
 public:
-    Circuit(const char *const filename);
+    Circuit(const char *const filename, ThreadPool *const pool = 0);
     virtual ~Circuit();
 
     virtual void DisplayConst();
 
-    bool IsLoaded() const { return nb_segs != 0; };
-    float GetTotalLength() const { return totalLength; }
-
-    Basis GetBasis(float position) const;
-    float GetWidth(float position) const;
-    static float GetBorderSlope();
-
 private:
-    struct Point {
-	Vector point, normal, tangent;
-    };
-
-    struct Segment {
-	Vector points[4];
-	float length, width;
-	Basis basis;
-    };
-
     enum { TEX_CIRCUIT = 0, TEX_BORDER, TEX_NUM };
     Texture *textures[TEX_NUM];
-
-    int nb_segs;
-    Segment *segments;
-    float totalLength;
-
-    void AddSegment(const Point &start, const Point &end,
-		    std::vector<Segment> &segs);
 };
 
 } // namespace Podz
@@ -0,0 +1,167 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Client.cpp
+ * Description: Multiplayer Client
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// This module
+#include "Track.h"
+#include "Pod.h"
+#include "Race.h"
+#include "Socket.h"
+#include "Packet.h"
+#include "Snapshot.h"
+#include "Client.h"
+
+
+namespace Podz {
+
+Client::Client(const Track &trk, const unsigned level, const int tickRate)
+    : track(trk), levelHash(level), rate(tickRate), pod(-1), refused(false),
+      sequence(0), latest(0), bytesReceived(0)
+{
+    server.host = 0;
+    server.port = 0;
+}
+
+bool Client::Connect(const char *const address)
+{
+    return Socket::Resolve(address, server) && socket.Open();
+}
+
+void Client::Send(const unsigned input)
+{
+    if (pod < 0) {
+	packet.Start(Packet::HELLO);
+	packet.WriteNumber(levelHash);
+	packet.WriteNumber(static_cast<unsigned>(rate));
+    } else {
+	// The acknowledged tick is offset by one, 0 meaning none
+	packet.Start(Packet::INPUT);
+	packet.WriteNumber(++sequence);
+	packet.WriteNumber(received[latest % Snapshot::HISTORY].GetTick()
+			   == latest ? static_cast<unsigned>(latest) + 1u
+				     : 0u);
+	packet.WriteByte(input & Pod::INPUT_MASK);
+    }
+    socket.Send(server, packet.GetData(), packet.GetSize());
+}
+
+bool Client::Receive()
+{
+    bool updated = false;
+    Socket::Address from;
+    int length;
+    while ((length = socket.Receive(from, packet.GetData(),
+				    Packet::MAX_SIZE)) > 0) {
+	if (from != server)
+	    continue;
+	bytesReceived += static_cast<unsigned long>(length);
+
+	const unsigned type = packet.Open(length);
+	if (type == Packet::WELCOME) {
+	    const unsigned number = packet.ReadNumber();
+	    if (!packet.HasError() && pod < 0)
+		pod = static_cast<int>(number);
+	} else if (type == Packet::REFUSED) {
+	    // Once connected, the server dropped the client: join again
+	    if (pod >= 0)
+		pod = -1;
+	    else
+		refused = true;
+	} else if (type == Packet::SNAPSHOT && pod >= 0) {
+	    const int tick = static_cast<int>(packet.ReadNumber());
+	    const int distance = static_cast<int>(packet.ReadNumber());
+	    packet.ReadNumber(); // Client pod, already known
+	    if (packet.HasError() || tick <= latest ||
+		distance < 0 || distance >= Snapshot::HISTORY)
+		continue;
+
+	    // Without its base, a snapshot cannot be read: the server will
+	    // send full ones until it learns what the client has
+	    const Snapshot *base = 0;
+	    if (distance > 0) {
+		base = &received[(tick - distance) % Snapshot::HISTORY];
+		if (base->GetTick() != tick - distance)
+		    continue;
+	    }
+	    Snapshot &snapshot = received[tick % Snapshot::HISTORY];
+	    if (snapshot.Read(packet, tick, base)) {
+		latest = tick;
+		updated = true;
+	    } else
+		snapshot.Clear(-1);
+	}
+    }
+
+    return updated;
+}
+
+void Client::Apply(Race &race)
+{
+    const int count = race.GetPodCount();
+    if (static_cast<int>(slots.size()) != count) {
+	slots.assign(count, -1);
+	cursors.assign(count, 0);
+    }
+    slots[0] = pod;
+
+    // Free the race pods of the server pods out of sight
+    const Snapshot &snapshot = GetSnapshot();
+    for (int s = 1; s < count; ++s)
+	if (slots[s] >= 0 && snapshot.Find(slots[s]) == 0)
+	    slots[s] = -1;
+
+    Pod::State state;
+    for (int i = 0; i < snapshot.GetCount(); ++i) {
+	const Snapshot::Sample &sample = snapshot.GetSample(i);
+	int slot = -1, free = -1;
+	for (int s = 0; s < count && slot < 0; ++s) {
+	    if (slots[s] == sample.pod)
+		slot = s;
+	    else if (slots[s] < 0 && free < 0)
+		free = s;
+	}
+	if (slot < 0 && free >= 0)
+	    slots[slot = free] = sample.pod;
+	if (slot < 0)
+	    continue;
+
+	Snapshot::Restore(track, sample, state, &cursors[slot]);
+	race.GetPod(slot).Restore(state);
+    }
+}
+
+} // namespace Podz
+
+// End of File
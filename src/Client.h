@@ -0,0 +1,103 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Client.h
+ * Description: Multiplayer Client (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_CLIENT_H
+#define PODZ_CLIENT_H
+
+#include <vector>
+
+#include "Socket.h"
+#include "Packet.h"
+#include "Snapshot.h"
+
+namespace Podz
+{
+
+class Track;
+class Race;
+
+// Player of a race run by a server: sends the player input every tick and
+// receives the state of the pods around it, which it does not simulate
+class Client
+{
+public:
+    Client(const Track &trk, const unsigned level, const int tickRate);
+
+    // Server address, as "host" or "host:port"
+    bool Connect(const char *const address);
+
+    // Once per tick: the input, and whether a newer snapshot arrived since
+    // the previous call; until the server welcomes the client, the input
+    // is replaced by a request to join, sent again if the server drops it
+    void Send(const unsigned input);
+    bool Receive();
+
+    bool IsConnected() const { return pod >= 0; }
+    bool IsRefused() const { return refused; }
+    int GetPod() const { return pod; }
+    const Snapshot &GetSnapshot() const
+	{ return received[latest % Snapshot::HISTORY]; }
+
+    // Sets the pods of the race to the latest snapshot: the client pod is
+    // the first one, the others keep the same race pod as long as they are
+    // seen
+    void Apply(Race &race);
+
+    // Total since the client was created
+    unsigned long GetBytesReceived() const { return bytesReceived; }
+
+private:
+    const Track &track;
+    const unsigned levelHash;
+    const int rate;
+    Socket socket;
+    Socket::Address server;
+    Packet packet;
+
+    int pod;
+    bool refused;
+    unsigned sequence;
+    int latest; // Tick of the latest snapshot, 0 for none
+    Snapshot received[Snapshot::HISTORY];
+    std::vector<int> slots;   // Server pod of each race pod, -1 for none
+    std::vector<int> cursors; // Track segment hints of the race pods
+    unsigned long bytesReceived;
+
+    // No copy
+    Client(const Client &);
+    void operator =(const Client &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_CLIENT_H
+
+// End of File
@@ -0,0 +1,96 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Clock.cpp
+ * Description: Monotonic Clock
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN 1
+# include <windows.h>
+#else // !_WIN32
+# include <time.h>
+# include <sys/time.h>
+#endif // !_WIN32
+
+// This module
+#include "Clock.h"
+
+namespace Podz {
+
+double Clock::GetTime()
+{
+#ifdef _WIN32
+    static double period = 0.;
+    LARGE_INTEGER counter;
+
+    if (period == 0.) {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	period = 1. / static_cast<double>(frequency.QuadPart);
+    }
+
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * period;
+#elif defined(HAVE_CLOCK_GETTIME)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) +
+	   static_cast<double>(now.tv_nsec) * 1e-9;
+#else // !_WIN32 && !HAVE_CLOCK_GETTIME
+    // Not monotonic, but the best we can get on this system
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return static_cast<double>(now.tv_sec) +
+	   static_cast<double>(now.tv_usec) * 1e-6;
+#endif // !_WIN32 && !HAVE_CLOCK_GETTIME
+}
+
+void Clock::Sleep(const double seconds)
+{
+    if (seconds <= 0.)
+	return;
+
+#ifdef _WIN32
+    ::Sleep(static_cast<DWORD>(seconds * 1000. + .5));
+#else // !_WIN32
+    struct timespec duration;
+    duration.tv_sec = static_cast<time_t>(seconds);
+    duration.tv_nsec = static_cast<long>((seconds - duration.tv_sec) * 1e9);
+    nanosleep(&duration, 0);
+#endif // !_WIN32
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,51 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Clock.h
+ * Description: Monotonic Clock (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_CLOCK_H
+#define PODZ_CLOCK_H
+
+namespace Podz {
+
+class Clock
+{
+public:
+    // Seconds elapsed since an arbitrary origin; never goes backwards
+    static double GetTime();
+
+    // Waits for the given number of seconds, at least
+    static void Sleep(const double seconds);
+};
+
+} // namespace Podz
+
+#endif // !PODZ_CLOCK_H
+
+// End of File
@@ -0,0 +1,187 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Dedicated.cpp
+ * Description: Dedicated Multiplayer Server Program
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// Windows
+#ifdef _WIN32
+# define DIRSEP "\\"
+#else // !_WIN32
+# define DIRSEP "/"
+#endif // !_WIN32
+
+// STL
+#include <iostream>
+
+// System
+#include <cstdlib>
+#include <cstring>
+
+// This module
+#include "Clock.h"
+#include "Track.h"
+#include "Replay.h"
+#include "RacingLine.h"
+#include "ThreadPool.h"
+#include "Socket.h"
+#include "Server.h"
+
+
+namespace Podz {
+
+// Statistics are printed that often, in seconds
+static const int REPORT_SECONDS = 5;
+
+static int Usage(const char *const name)
+{
+    std::cerr << "Usage: " << name
+	      << " [-j THREADS] [-r RATE] [-p PODS] [-P PORT] [-n TICKS]"
+		 " [LEVEL]" << std::endl;
+    return EXIT_FAILURE;
+}
+
+static int Serve(int argc, char **argv)
+{
+    int rate = 100, nb_pods = 8, threads = 0, ticks = 0;
+    int port = Socket::DEFAULT_PORT;
+    const char *level = 0;
+
+    for (int i = 1; i < argc; ++i) {
+	if (argv[i][0] != '-' && level == 0)
+	    level = argv[i];
+	else if (i + 1 >= argc)
+	    return Usage(argv[0]);
+	else if (std::strcmp(argv[i], "-j") == 0)
+	    threads = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-r") == 0)
+	    rate = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-p") == 0)
+	    nb_pods = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-P") == 0)
+	    port = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-n") == 0)
+	    ticks = std::atoi(argv[++i]);
+	else
+	    return Usage(argv[0]);
+    }
+    if (rate <= 0 || nb_pods <= 0 || threads < 0 || ticks < 0 ||
+	port <= 0 || port > 65535)
+	return Usage(argv[0]);
+
+    // Default level: look in the same places as the game does
+    static const char *const levels[] = {
+#ifdef DATA_DIR
+	DATA_DIR DIRSEP "level.txt",
+#endif // DATA_DIR
+	"data" DIRSEP "level.txt", ".." DIRSEP "data" DIRSEP "level.txt"
+    };
+    ThreadPool pool(threads);
+    Track *track = 0;
+    if (level != 0)
+	track = new Track(level, &pool);
+    else {
+	for (unsigned i = 0; i < sizeof(levels) / sizeof(*levels); ++i) {
+	    delete track;
+	    track = new Track(level = levels[i], &pool);
+	    if (track->IsLoaded())
+		break;
+	}
+    }
+    unsigned levelHash = 0;
+    if (!track->IsLoaded() || !Replay::HashLevel(level, levelHash)) {
+	std::cerr << "Error: could not load level '" << level << "'."
+		  << std::endl;
+	delete track;
+	return EXIT_FAILURE;
+    }
+
+    RacingLine racing(*track);
+    racing.Load(RacingLine::GetFileName(level).c_str());
+    Server *const server = new Server(*track, levelHash, rate, nb_pods,
+				      &pool, &racing);
+    if (!server->Open(static_cast<unsigned short>(port))) {
+	std::cerr << "Error: could not listen on port " << port << "."
+		  << std::endl;
+	delete server;
+	delete track;
+	return EXIT_FAILURE;
+    }
+    std::cout << "Serving '" << level << "' to " << nb_pods << " pods at "
+	      << rate << " Hz on port " << port << std::endl;
+
+    // Real time: late ticks are run at once, unless far behind
+    const double dt = 1. / static_cast<double>(rate);
+    const int report = REPORT_SECONDS * rate;
+    double next = Clock::GetTime(), busy = 0.;
+    unsigned long bytes = 0, snapshots = 0;
+    for (int tick = 1; ticks == 0 || tick <= ticks; ++tick) {
+	const double now = Clock::GetTime();
+	if (now > next + 1.)
+	    next = now;
+	Clock::Sleep(next - now);
+	next += dt;
+
+	const double start = Clock::GetTime();
+	server->Tick();
+	busy += Clock::GetTime() - start;
+
+	if (tick % report == 0) {
+	    const unsigned long sent = server->GetSnapshotsSent() - snapshots;
+	    const double size = sent > 0 ? static_cast<double>(
+		    server->GetBytesSent() - bytes) / sent : 0.;
+	    std::cout << "Tick " << server->GetRace().GetTick() << ": "
+		      << server->GetClientCount() << " clients, "
+		      << busy / report * 1e6 << " us/tick, "
+		      << size << " bytes/snapshot, " << size * rate
+		      << " B/s per client" << std::endl;
+	    bytes = server->GetBytesSent();
+	    snapshots = server->GetSnapshotsSent();
+	    busy = 0.;
+	}
+    }
+
+    delete server;
+    delete track;
+    return EXIT_SUCCESS;
+}
+
+} // namespace Podz
+
+
+extern "C" int main(int argc, char **argv)
+{
+    return Podz::Serve(argc, argv);
+}
+
+// End of File
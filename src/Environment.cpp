@@ -0,0 +1,219 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Environment.cpp
+ * Description: Vectorized Training Environment
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Physics.h"
+#include "Numeric.h"
+#include "Pod.h"
+#include "ThreadPool.h"
+#include "Environment.h"
+
+
+namespace Podz {
+
+const float Environment::lookahead[LOOKAHEAD_NUM] = { 2.f, 5.f, 10.f, 20.f };
+
+class Environment::ResetTask : public ThreadPool::Task
+{
+public:
+    ResetTask(Environment &env, float *const obs)
+	: environment(env), observations(obs) {}
+
+    virtual void Run(const int index)
+    {
+	environment.Reset(index, observations + index * OBSERVATION_SIZE);
+    }
+
+private:
+    Environment &environment;
+    float *const observations;
+
+    void operator =(const ResetTask &) const;
+};
+
+class Environment::StepTask : public ThreadPool::Task
+{
+public:
+    StepTask(Environment &env, const unsigned *const act, float *const obs,
+	     float *const rew, unsigned char *const dn)
+	: environment(env), actions(act), observations(obs), rewards(rew),
+	  dones(dn) {}
+
+    virtual void Run(const int index)
+    {
+	environment.Step(index, actions[index],
+			 observations + index * OBSERVATION_SIZE,
+			 rewards[index], dones[index]);
+    }
+
+private:
+    Environment &environment;
+    const unsigned *const actions;
+    float *const observations, *const rewards;
+    unsigned char *const dones;
+
+    void operator =(const StepTask &) const;
+};
+
+Environment::Environment(const Track &trk, const int nb, const int rate,
+			 const int max, ThreadPool *const thrpool)
+    : track(trk), count(nb), dt(1.f / static_cast<float>(rate)),
+      maxTicks(max), pool(thrpool), pods(nb), ticks(nb, 0),
+      cursors(nb * (LOOKAHEAD_NUM + 1), 0)
+{
+    for (int i = 0; i < count; ++i)
+	pods[i] = new Pod(track); // Standard ones, stepped as such
+}
+
+Environment::~Environment()
+{
+    for (int i = 0; i < count; ++i)
+	delete pods[i];
+}
+
+void Environment::Reset(float *const observations)
+{
+    ResetTask task(*this, observations);
+    if (pool != 0)
+	pool->Run(task, count);
+    else {
+	for (int i = 0; i < count; ++i)
+	    task.Run(i);
+    }
+}
+
+void Environment::Step(const unsigned *const actions,
+		       float *const observations, float *const rewards,
+		       unsigned char *const dones)
+{
+    StepTask task(*this, actions, observations, rewards, dones);
+    if (pool != 0)
+	pool->Run(task, count);
+    else {
+	for (int i = 0; i < count; ++i)
+	    task.Run(i);
+    }
+}
+
+void Environment::Reset(const int index, float *const observation)
+{
+    pods[index]->Init();
+    ticks[index] = 0;
+    Observe(index, observation);
+}
+
+void Environment::Step(const int index, const unsigned action,
+		       float *const observation, float &reward,
+		       unsigned char &done)
+{
+    Pod &pod = *pods[index];
+    const float start = pod.GetCircPosition();
+    pod.StepClass<StandardHandling>(action & Pod::INPUT_MASK, dt);
+    reward = pod.GetCircPosition() - start;
+
+    done = 0;
+    if (pod.HasFinished())
+	done |= DONE_FINISHED;
+    if (++ticks[index] == maxTicks)
+	done |= DONE_TIMEOUT;
+
+    if (done != 0)
+	Reset(index, observation);
+    else
+	Observe(index, observation);
+}
+
+void Environment::Observe(const int index, float *const observation)
+{
+    const Pod &pod = *pods[index];
+    const Basis &basis = pod.GetBasis();
+    const float position = pod.GetCircPosition();
+    // One segment hint per query distance, each staying close to the last
+    int *const cursor = &cursors[index * (LOOKAHEAD_NUM + 1)];
+
+    const Vector speed = basis.RevertVector(pod.GetSpeed());
+    const Vector local = basis.RevertPoint(pod.GetPosition());
+    observation[OBS_SPEED_X] = speed.x;
+    observation[OBS_SPEED_Y] = speed.y;
+    observation[OBS_SPEED_Z] = speed.z;
+    observation[OBS_OFFSET] = local.x
+			    / (track.GetWidth(position, cursor) * .5f);
+    observation[OBS_HEIGHT] = local.y;
+    observation[OBS_HEADING_SIN] = Numeric::Sin(pod.GetAngle());
+    observation[OBS_HEADING_COS] = Numeric::Cos(pod.GetAngle());
+    observation[OBS_ACCELERATION] = pod.GetAcceleration();
+    observation[OBS_SLOPE] = pod.GetSlope();
+    observation[OBS_WRONG_WAY] = pod.IsWrongWay() ? 1.f : 0.f;
+
+    // All the frames ahead in a single batched query
+    float positions[LOOKAHEAD_NUM], ahead[Track::FRAME_NUM][LOOKAHEAD_NUM];
+    float *frames[Track::FRAME_NUM] = { 0 };
+    for (int i = 0; i < LOOKAHEAD_NUM; ++i)
+	positions[i] = position + lookahead[i];
+    for (int i = Track::FRAME_ORIGIN_X; i <= Track::FRAME_ORIGIN_Z; ++i)
+	frames[i] = ahead[i];
+    for (int i = Track::FRAME_BACKWARD_X; i <= Track::FRAME_BACKWARD_Z; ++i)
+	frames[i] = ahead[i];
+    track.GetFrames(positions, LOOKAHEAD_NUM, frames, cursor + 1);
+
+    float *frame = observation + OBS_LOOKAHEAD;
+    for (int i = 0; i < LOOKAHEAD_NUM; ++i, frame += LOOKAHEAD_SIZE) {
+	const Vector origin = basis.RevertPoint(
+	    Vector(ahead[Track::FRAME_ORIGIN_X][i],
+		   ahead[Track::FRAME_ORIGIN_Y][i],
+		   ahead[Track::FRAME_ORIGIN_Z][i]));
+	const Vector forward = basis.RevertVector(
+	    -Vector(ahead[Track::FRAME_BACKWARD_X][i],
+		    ahead[Track::FRAME_BACKWARD_Y][i],
+		    ahead[Track::FRAME_BACKWARD_Z][i]));
+	frame[LOOKAHEAD_ORIGIN_X] = origin.x;
+	frame[LOOKAHEAD_ORIGIN_Y] = origin.y;
+	frame[LOOKAHEAD_ORIGIN_Z] = origin.z;
+	frame[LOOKAHEAD_FORWARD_X] = forward.x;
+	frame[LOOKAHEAD_FORWARD_Y] = forward.y;
+	frame[LOOKAHEAD_FORWARD_Z] = forward.z;
+    }
+}
+
+} // namespace Podz
+
+// End of File
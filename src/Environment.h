@@ -0,0 +1,125 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Environment.h
+ * Description: Vectorized Training Environment (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_ENVIRONMENT_H
+#define PODZ_ENVIRONMENT_H
+
+#include <vector>
+
+namespace Podz
+{
+
+class Track;
+class Pod;
+class ThreadPool;
+
+// Many independent single-pod episodes on the same track, stepped together
+// for training driving agents: every call takes one action per episode
+// and returns observations, rewards and episode ends for all of them.
+//
+// Actions are input bit masks (Pod::Input).  The reward is the distance
+// covered along the track during the step.  An episode ends when the pod
+// has finished the race or after a number of ticks; it then starts over at
+// once, and the observation returned is the first one of the new episode.
+class Environment
+{
+public:
+    // Observation of one pod, in the track frame at its position; lengths
+    // are in track units, speeds in units per second
+    enum Observation {
+	OBS_SPEED_X = 0, OBS_SPEED_Y, OBS_SPEED_Z, // Local velocity
+	OBS_OFFSET,         // Lateral offset, over the half track width
+	OBS_HEIGHT,         // Height above the track
+	OBS_HEADING_SIN, OBS_HEADING_COS, // Heading relative to the track
+	OBS_ACCELERATION, OBS_SLOPE, OBS_WRONG_WAY,
+	OBS_LOOKAHEAD       // Track frames ahead, LOOKAHEAD_SIZE floats each
+    };
+
+    // Track frame ahead: its origin and forward direction, in the local frame
+    enum Lookahead {
+	LOOKAHEAD_ORIGIN_X = 0, LOOKAHEAD_ORIGIN_Y, LOOKAHEAD_ORIGIN_Z,
+	LOOKAHEAD_FORWARD_X, LOOKAHEAD_FORWARD_Y, LOOKAHEAD_FORWARD_Z,
+	LOOKAHEAD_SIZE
+    };
+
+    enum {
+	LOOKAHEAD_NUM = 4,
+	OBSERVATION_SIZE = OBS_LOOKAHEAD + LOOKAHEAD_NUM * LOOKAHEAD_SIZE
+    };
+
+    // Episode end flags
+    enum { DONE_FINISHED = 1, DONE_TIMEOUT = 2 };
+
+    Environment(const Track &trk, const int nb, const int rate = 100,
+		const int maxTicks = 0, ThreadPool *const thrpool = 0);
+    ~Environment();
+
+    int GetCount() const { return count; }
+    const Pod &GetPod(const int index) const { return *pods[index]; }
+
+    // Observations are OBSERVATION_SIZE floats per episode, rewards one
+    // float and ends one byte, zero while the episode goes on
+    void Reset(float *const observations);
+    void Step(const unsigned *const actions, float *const observations,
+	      float *const rewards, unsigned char *const dones);
+
+    // Distances of the lookahead frames
+    static const float lookahead[LOOKAHEAD_NUM];
+
+private:
+    const Track &track;
+    int count;
+    float dt;
+    int maxTicks;
+    ThreadPool *pool;
+
+    std::vector<Pod *> pods;
+    std::vector<int> ticks;
+    std::vector<int> cursors; // Segment lookup hints, per query distance
+
+    class ResetTask;
+    class StepTask;
+
+    void Reset(const int index, float *const observation);
+    void Step(const int index, const unsigned action,
+	      float *const observation, float &reward, unsigned char &done);
+    void Observe(const int index, float *const observation);
+
+    // No copy
+    Environment(const Environment &);
+    void operator =(const Environment &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_ENVIRONMENT_H
+
+// End of File
@@ -0,0 +1,132 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/History.cpp
+ * Description: Race Snapshots for Rewinding
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// This module
+#include "Pod.h"
+#include "Race.h"
+#include "History.h"
+
+
+namespace Podz {
+
+History::History(Race &rc, const float step, const int capacity,
+		 const int intvl)
+    : race(rc), dt(step), nb_snaps(capacity), interval(intvl),
+      nb_pods(rc.GetPodCount()), first(0), count(0)
+{
+    ticks = new int[nb_snaps];
+    states = new Pod::State[nb_snaps * nb_pods];
+
+    // Enough inputs to simulate from the oldest snapshot to the next one
+    nb_inputs = (nb_snaps + 1) * interval;
+    inputs = new unsigned char[nb_inputs * nb_pods];
+
+    Clear();
+}
+
+History::~History()
+{
+    delete[] inputs;
+    delete[] states;
+    delete[] ticks;
+}
+
+void History::Clear()
+{
+    first = 0;
+    count = 0;
+    Snap();
+}
+
+void History::Record()
+{
+    const int tick = race.GetTick();
+
+    // Inputs of the step just done
+    unsigned char *const input = inputs
+			       + (tick - 1) % nb_inputs * nb_pods;
+    for (int i = 0; i < nb_pods; ++i)
+	input[i] = static_cast<unsigned char>(race.GetInput(i));
+
+    if (tick % interval == 0)
+	Snap();
+}
+
+int History::GetFirstTick() const
+{
+    return ticks[first];
+}
+
+bool History::Seek(const int tick)
+{
+    if (tick < ticks[first] || tick > race.GetTick())
+	return false;
+
+    // Latest snapshot not after the wanted tick, dropping the newer ones
+    while (count > 1 && ticks[(first + count - 1) % nb_snaps] > tick)
+	--count;
+    const int last = (first + count - 1) % nb_snaps;
+    race.Restore(states + last * nb_pods, ticks[last]);
+
+    while (race.GetTick() < tick) {
+	const unsigned char *const input = inputs
+					 + race.GetTick() % nb_inputs
+					 * nb_pods;
+	for (int i = 0; i < nb_pods; ++i)
+	    race.SetInput(i, input[i]);
+	race.Step(dt);
+    }
+
+    return true;
+}
+
+void History::Snap()
+{
+    int slot;
+    if (count < nb_snaps)
+	slot = (first + count++) % nb_snaps;
+    else {
+	slot = first;
+	first = (first + 1) % nb_snaps;
+    }
+
+    ticks[slot] = race.GetTick();
+    race.Save(states + slot * nb_pods);
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,93 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/History.h
+ * Description: Race Snapshots for Rewinding (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_HISTORY_H
+#define PODZ_HISTORY_H
+
+#include "Pod.h"
+
+namespace Podz
+{
+
+class Race;
+
+// Recent past of a race: a ring buffer of snapshots of all pods, taken
+// every few ticks, and of the inputs of every tick since the oldest one.
+// Seeking restores the closest snapshot before the wanted tick and
+// simulates again from it.  All memory is allocated up front, recording a
+// tick only copies plain data.
+class History
+{
+public:
+    // Keeps capacity snapshots, one every interval ticks, of the race as it
+    // is now (its pods are not to change afterwards)
+    History(Race &rc, const float step, const int capacity,
+	    const int interval);
+    ~History();
+
+    // Forget the past, starting over from the current race state
+    void Clear();
+
+    // To be called after every step of the race
+    void Record();
+
+    // Oldest tick that can still be reached
+    int GetFirstTick() const;
+
+    // Go back to a past tick of the race, false if too old or in the future
+    bool Seek(const int tick);
+
+private:
+    Race &race;
+    float dt;
+    int nb_snaps, interval, nb_pods;
+
+    // Snapshot ring: the race tick of each, and the state of all pods
+    int *ticks;
+    Pod::State *states;
+    int first, count;
+
+    // Input ring, nb_pods entries per tick
+    unsigned char *inputs;
+    int nb_inputs;
+
+    void Snap();
+
+    // No copy
+    History(const History &);
+    void operator =(const History &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_HISTORY_H
+
+// End of File
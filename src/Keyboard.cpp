@@ -34,14 +34,23 @@
 # include <config.h>
 #endif // HAVE_CONFIG_H
 
+// STL
+#include <iostream>
+
 // OpenGL
 #define PODZ_USE_GLUT
 #include "OpenGL.h"
 
 // This module
-#include "Vehicle.h"
+#include "Pod.h"
+#include "Race.h"
+#include "Replay.h"
+#include "History.h"
+#include "Client.h"
+#include "LapSplits.h"
 #include "Display.h"
 #include "Texture.h"
+#include "LineOverlay.h"
 #include "Timer.h"
 #include "Application.h"
 #include "Keyboard.h"
@@ -52,8 +61,9 @@ namespace Podz
 
 Keyboard *Keyboard::instance = 0;
 
-Keyboard::Keyboard(Display &disp, Vehicle &vehi)
-    : display(disp), vehicle(vehi), timer(0)
+Keyboard::Keyboard(Display &disp, Race &rc)
+    : display(disp), race(rc), timer(0), replay(0), playback(false),
+      history(0), client(0), splits(0)
 {
     if (glutDeviceGet(GLUT_HAS_KEYBOARD) != 1)
 	return;
@@ -73,18 +83,47 @@ void Keyboard::RegisterCallbacks()
     glutIgnoreKeyRepeat(2);
 }
 
-void Keyboard::CheckKeys() const
+void Keyboard::CheckKeys(const float dt) const
 {
-    if (pressed[KEY_UP])
-	vehicle.Accelerate();
-    if (pressed[KEY_DOWN])
-	vehicle.Brake();
-    if (pressed[KEY_LEFT])
-	vehicle.TurnLeft();
-    if (pressed[KEY_RIGHT])
-	vehicle.TurnRight();
-
-    vehicle.Move();
+    unsigned input = 0;
+    if (playback) {
+	if (!replay->Play(input))
+	    input = 0;
+    } else {
+	if (pressed[KEY_UP])
+	    input |= Pod::INPUT_ACCELERATE;
+	if (pressed[KEY_DOWN])
+	    input |= Pod::INPUT_BRAKE;
+	if (pressed[KEY_LEFT])
+	    input |= Pod::INPUT_LEFT;
+	if (pressed[KEY_RIGHT])
+	    input |= Pod::INPUT_RIGHT;
+	if (replay != 0)
+	    replay->Record(input);
+    }
+
+    if (client != 0) {
+	if (client->Receive())
+	    client->Apply(race);
+	if (client->IsRefused()) {
+	    std::cerr << "Error: the server refused to let us race."
+		      << std::endl;
+	    Application::Exit(4);
+	}
+	client->Send(input);
+    } else {
+	race.SetInput(0, input);
+	race.Step(dt);
+	if (history != 0)
+	    history->Record();
+    }
+    // The step ends a tick later than the timer says
+    const Pod &pod = race.GetPod(0);
+    if (splits != 0)
+	splits->Record(pod.GetLap(), pod.GetLapPosition(),
+		       timer->GetTime() + timer->GetStep());
+    if (pod.HasFinished())
+	timer->Finish();
 }
 
 void Keyboard::UpdateKey(int key, bool state)
@@ -107,6 +146,27 @@ void Keyboard::UpdateKey(int key, bool state)
     }
 }
 
+void Keyboard::Rewind()
+{
+    if (history == 0 || !timer->HasStarted())
+	return;
+
+    // One second back, or as far as the history goes
+    int tick = race.GetTick() - static_cast<int>(1. / timer->GetStep() + .5);
+    if (tick < history->GetFirstTick())
+	tick = history->GetFirstTick();
+    if (!history->Seek(tick))
+	return;
+
+    timer->Rewind(tick);
+    if (replay != 0) {
+	if (playback)
+	    replay->Seek(tick);
+	else
+	    replay->Truncate(tick);
+    }
+}
+
 void Keyboard::KeyPressed(unsigned char key, int, int)
 {
     switch (key) {
@@ -128,8 +188,26 @@ void Keyboard::KeyPressed(unsigned char key, int, int)
 
     case 'R':
     case 'r':
-	vehicle.Init();
+	// A race run by a server cannot be restarted
+	if (client != 0)
+	    break;
+	race.Init();
 	timer->Reset();
+	if (splits != 0)
+	    splits->Restart();
+	if (history != 0)
+	    history->Clear();
+	if (replay != 0) {
+	    if (playback) {
+		replay->Rewind();
+		timer->Start();
+	    } else
+		replay->Clear();
+	}
+	break;
+
+    case 8: // Backspace
+	Rewind();
 	break;
 
     case 'L':
@@ -138,6 +216,13 @@ void Keyboard::KeyPressed(unsigned char key, int, int)
 	glutPostRedisplay();
 	break;
 
+    case 'G':
+    case 'g':
+	LineOverlay::ToogleVisibility();
+	display.RebuildLists();
+	glutPostRedisplay();
+	break;
+
     case 'T':
     case 't':
 	Texture::ToogleTexturing();
@@ -36,28 +36,54 @@ namespace Podz
 {
 
 class Display;
-class Vehicle;
+class Race;
 class Timer;
+class Replay;
+class History;
+class Client;
+class LapSplits;
 
 class Keyboard
 {
 public:
-    Keyboard(Display &disp, Vehicle &vehi);
+    // The player pod is the first one of the race
+    Keyboard(Display &disp, Race &rc);
 
     static void RegisterCallbacks();
-    void CheckKeys() const;
+    void CheckKeys(const float dt) const;
     void SetTimer(Timer *const tmr) { timer = tmr; }
 
+    // Either record the player inputs, or play them back instead of reading
+    // the keyboard
+    void SetReplay(Replay *const rep, const bool play)
+	{ replay = rep; playback = play; }
+
+    // Past of the race, for rewinding
+    void SetHistory(History *const hist) { history = hist; }
+
+    // Race run by a server instead: the inputs are sent to it, and the pods
+    // follow its snapshots
+    void SetClient(Client *const clt) { client = clt; }
+
+    // Split times of the player pod, recorded every tick
+    void SetSplits(LapSplits *const spl) { splits = spl; }
+
 private:
     enum { KEY_UP = 0, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_NUM };
 
     Display &display;
-    Vehicle &vehicle;
+    Race &race;
     Timer *timer;
+    Replay *replay;
+    bool playback;
+    History *history;
+    Client *client;
+    LapSplits *splits;
 
     bool pressed[KEY_NUM];
 
     void UpdateKey(int key, bool state);
+    void Rewind();
 
     void KeyPressed(unsigned char key, int x, int y);
     void SpecialKeyPressed(int key, int x, int y);
@@ -0,0 +1,129 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/LapSplits.cpp
+ * Description: Split Times Against the Best Lap
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "LapSplits.h"
+
+
+namespace Podz {
+
+LapSplits::LapSplits(const float length, const float bucket)
+    : lapLength(length), bucketLength(bucket),
+      count(static_cast<int>(ceilf(length / bucket))),
+      current(count, 0.), best(count, 0.)
+{
+    Clear();
+}
+
+void LapSplits::Restart()
+{
+    reached = 0;
+    lap = 0;
+    start = 0.;
+    complete = false;
+    position = 0.f;
+    time = 0.;
+}
+
+void LapSplits::Clear()
+{
+    bestTime = 0.;
+    Restart();
+}
+
+int LapSplits::GetBucket(const float lapPosition) const
+{
+    const int bucket = static_cast<int>(lapPosition / bucketLength);
+    return bucket < 0 ? 0 : bucket < count ? bucket : count - 1;
+}
+
+void LapSplits::Record(const int lapNumber, const float lapPosition,
+		       const double now)
+{
+    if (lapNumber != lap) {
+	// Only a lap recorded all along may become the best one
+	const bool next = lapNumber == lap + 1;
+	if (next && complete && reached == count &&
+	    (bestTime == 0. || now - start < bestTime)) {
+	    current.swap(best);
+	    bestTime = now - start;
+	}
+
+	// The first lap starts with the race; a lap joined on the way, or
+	// gone back to by rewinding, has no known start
+	start = lap == 0 ? 0. : now;
+	complete = next && lapPosition < bucketLength;
+	lap = lapNumber;
+	reached = 0;
+    } else if (now < time) {
+	// Rewound: forget the buckets reached since
+	while (reached > 0 && current[reached - 1] > now - start)
+	    --reached;
+    }
+
+    // Buckets are filled as their start is passed, wrong way excepted
+    if (lapPosition >= 0.f) {
+	const int bucket = GetBucket(lapPosition);
+	while (reached <= bucket)
+	    current[reached++] = now - start;
+    }
+
+    position = lapPosition;
+    time = now;
+}
+
+bool LapSplits::GetDelta(double &delta) const
+{
+    if (!complete || bestTime == 0. || position < 0.f)
+	return false;
+
+    // Best time at the same position, between the bucket bounds
+    const int bucket = GetBucket(position);
+    const float begin = static_cast<float>(bucket) * bucketLength;
+    const float end = bucket + 1 < count ? begin + bucketLength : lapLength;
+    const double after = bucket + 1 < count ? best[bucket + 1] : bestTime;
+    const double fraction = end > begin ? (position - begin) / (end - begin)
+					: 0.;
+    delta = time - start - (best[bucket] + (after - best[bucket]) * fraction);
+    return true;
+}
+
+} // namespace Podz
+
+// End of File
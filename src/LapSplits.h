@@ -0,0 +1,89 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/LapSplits.h
+ * Description: Split Times Against the Best Lap (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_LAPSPLITS_H
+#define PODZ_LAPSPLITS_H
+
+#include <vector>
+
+namespace Podz
+{
+
+// Time elapsed since the start of the lap, indexed by lap position in
+// buckets of fixed length: the current lap is filled in as the pod goes,
+// and kept as the best one when it is faster.  Both recording and looking
+// up take constant time.
+class LapSplits
+{
+public:
+    LapSplits(const float lapLength, const float bucketLength = 1.f);
+
+    // Forgets the current lap, or everything
+    void Restart();
+    void Clear();
+
+    // Once per tick: the pod lap and lap position, and the race time in
+    // seconds; going back in time (rewinding) is allowed
+    void Record(const int lap, const float lapPosition, const double time);
+
+    // Time difference with the best lap at the same position, as of the
+    // last record; false when there is no best lap or no current one
+    bool GetDelta(double &delta) const;
+    bool HasBest() const { return bestTime > 0.; }
+    double GetBestTime() const { return bestTime; }
+
+private:
+    const float lapLength, bucketLength;
+    const int count;
+
+    // Times at which the start of each bucket was first reached, the
+    // current lap being filled up to (not including) its reached bucket
+    std::vector<double> current, best;
+    int reached;
+    double bestTime;
+
+    // Current lap: number, start time, whether it was recorded from its
+    // start (only then is the start time known), and the last position
+    // and time
+    int lap;
+    double start;
+    bool complete;
+    float position;
+    double time;
+
+    int GetBucket(const float lapPosition) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_LAPSPLITS_H
+
+// End of File
@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/LineOverlay.cpp
+ * Description: Racing Line Overlay
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// OpenGL
+#define PODZ_USE_GL
+#include "OpenGL.h"
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "RacingLine.h"
+#include "LineOverlay.h"
+
+
+namespace Podz {
+
+// Points drawn per track unit, and height above the surface not to be
+// hidden by it
+static const float DENSITY = 2.f;
+static const float LIFT = .02f;
+
+bool LineOverlay::visible = true;
+
+LineOverlay::LineOverlay(const Track &trk, const RacingLine &ln)
+    : track(trk), line(ln)
+{}
+
+void LineOverlay::DisplayConst()
+{
+    if (!visible)
+	return;
+
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glColor3f(1.f, .8f, 0.f);
+    glLineWidth(2.f);
+
+    const int count = static_cast<int>(track.GetTotalLength() * DENSITY);
+    int cursor = 0;
+    glBegin(GL_LINE_LOOP);
+    for (int i = 0; i < count; ++i) {
+	const float position = static_cast<float>(i) / DENSITY;
+	const Basis basis = track.GetBasis(position, &cursor);
+	const Vector point = basis.TransformPoint(Vector(
+		line.GetOffset(position) * track.GetWidth(position, &cursor)
+		* .5f, LIFT, 0.f));
+	glVertex3f(point.x, point.y, point.z);
+    }
+    glEnd();
+}
+
+} // namespace Podz
+
+// End of File
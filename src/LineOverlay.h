@@ -0,0 +1,68 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/LineOverlay.h
+ * Description: Racing Line Overlay (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_LINEOVERLAY_H
+#define PODZ_LINEOVERLAY_H
+
+#include "Object.h"
+
+
+namespace Podz {
+
+class Track;
+class RacingLine;
+
+// Racing line drawn on the track surface
+class LineOverlay : public Object
+{
+public:
+    LineOverlay(const Track &trk, const RacingLine &ln);
+
+    virtual void DisplayConst();
+
+    // Display lists are to be rebuilt after toggling
+    static void ToogleVisibility() { visible = !visible; }
+
+private:
+    const Track &track;
+    const RacingLine &line;
+
+    static bool visible;
+
+    // No assignment
+    void operator =(const LineOverlay &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_LINEOVERLAY_H
+
+// End of File
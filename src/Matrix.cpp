@@ -0,0 +1,89 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Matrix.cpp
+ * Description: 3x3 Matrices and Vector Batches
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// This module
+#include "Vector.h"
+#include "Simd.h"
+#include "Matrix.h"
+
+namespace Podz {
+
+// Both normalizations share the gathering and scattering of the vectors;
+// the last group is padded with unit vectors
+template <bool FAST>
+static void NormalizeVectors(Vector *const vectors, const int count,
+			     const float n)
+{
+    for (int i = 0; i < count; i += 4) {
+	Vector group[4];
+	const int size = count - i < 4 ? count - i : 4;
+	for (int j = 0; j < 4; ++j)
+	    group[j] = j < size ? vectors[i + j] : Vector(1.f, 0.f, 0.f);
+
+	Float4 x(group[0].x, group[1].x, group[2].x, group[3].x);
+	Float4 y(group[0].y, group[1].y, group[2].y, group[3].y);
+	Float4 z(group[0].z, group[1].z, group[2].z, group[3].z);
+	const Float4 squared = x * x + y * y + z * z;
+	const Float4 scale = FAST ? Float4(n) * RSqrt(squared)
+				  : Float4(n) / Sqrt(squared);
+	x = x * scale;
+	y = y * scale;
+	z = z * scale;
+
+	float lanes[3][4];
+	x.StoreUnaligned(lanes[0]);
+	y.StoreUnaligned(lanes[1]);
+	z.StoreUnaligned(lanes[2]);
+	for (int j = 0; j < size; ++j)
+	    vectors[i + j].Set(lanes[0][j], lanes[1][j], lanes[2][j]);
+    }
+}
+
+void VectorBatch::Normalize(Vector *const vectors, const int count,
+			    const float n)
+{
+    NormalizeVectors<false>(vectors, count, n);
+}
+
+void VectorBatch::NormalizeFast(Vector *const vectors, const int count,
+				const float n)
+{
+    NormalizeVectors<true>(vectors, count, n);
+}
+
+} // namespace Podz
+
+// End of File
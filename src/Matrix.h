@@ -0,0 +1,95 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Matrix.h
+ * Description: 3x3 Matrices and Vector Batches (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_MATRIX_H
+#define PODZ_MATRIX_H
+
+#include "Vector.h"
+#include "Simd.h"
+
+namespace Podz {
+
+// 3x3 matrix, stored as three 4-wide columns so that products take one
+// SIMD operation per column.  Plain floats without alignment requirements,
+// to be copied and stored anywhere like the vectors.
+class Matrix
+{
+public:
+    Matrix() {}
+    Matrix(const Vector &c0, const Vector &c1, const Vector &c2)
+    {
+	SetColumn(0, c0);
+	SetColumn(1, c1);
+	SetColumn(2, c2);
+    }
+
+    // Same rounding as the scalar expression, in the same order
+    Vector Mult(const Vector &v) const
+    {
+	float r[4];
+	(Column(0) * Float4(v.x) + Column(1) * Float4(v.y)
+	 + Column(2) * Float4(v.z)).StoreUnaligned(r);
+	return Vector(r[0], r[1], r[2]);
+    }
+
+private:
+    float columns[3][4];
+
+    Float4 Column(const int i) const
+	{ return Float4::LoadUnaligned(columns[i]); }
+    void SetColumn(const int i, const Vector &c)
+    {
+	columns[i][0] = c.x;
+	columns[i][1] = c.y;
+	columns[i][2] = c.z;
+	columns[i][3] = 0.f;
+    }
+};
+
+// Operations over arrays of vectors, four at a time
+class VectorBatch
+{
+public:
+    // Same results as Vector::Normalize() on each vector
+    static void Normalize(Vector *const vectors, const int count,
+			  const float n = 1.f);
+
+    // From the reciprocal square root estimate: faster, but only about 22
+    // bits and processor dependent, for rendering and never for physics
+    static void NormalizeFast(Vector *const vectors, const int count,
+			      const float n = 1.f);
+};
+
+} // namespace Podz
+
+#endif // !PODZ_MATRIX_H
+
+// End of File
@@ -0,0 +1,198 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Numeric.cpp
+ * Description: Portable Math Functions
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "Numeric.h"
+
+#ifdef PODZ_DETERMINISTIC
+
+namespace Podz {
+
+// Every function works in double precision and rounds once to float at the
+// end: only additions, multiplications, divisions, square roots, floor()
+// and ldexp() are used, all of which IEEE 754 specifies exactly.
+
+static const double PI = 3.14159265358979311600;
+static const double HALF_PI = 1.57079632679489655800;
+static const double TWO_OVER_PI = .636619772367581382433;
+
+// Pi / 2 split in two, the high part with a short mantissa so that its
+// product by a small integer is exact (Cody & Waite reduction)
+static const double HALF_PI_HIGH = 1.57079632673412561417;
+static const double HALF_PI_LOW = 6.07710050650619224932e-11;
+
+// Same for ln(2)
+static const double LOG2_E = 1.44269504088896338700;
+static const double LN2_HIGH = 6.93147180369123816490e-1;
+static const double LN2_LOW = 1.90821492927058770002e-10;
+
+static const double SQRT3 = 1.73205080756887719318;
+static const double TAN_PI_12 = .267949192431122706473;
+
+// Taylor series on [-pi / 4, pi / 4], exact to the double precision
+static double SinSeries(const double r)
+{
+    const double r2 = r * r;
+    return r + r * r2 * (-1. / 6. + r2 * (1. / 120. + r2 * (-1. / 5040.
+	 + r2 * (1. / 362880. + r2 * (-1. / 39916800. + r2 * (1. / 6227020800.
+	 + r2 * (-1. / 1307674368000.)))))));
+}
+
+static double CosSeries(const double r)
+{
+    const double r2 = r * r;
+    return 1. + r2 * (-.5 + r2 * (1. / 24. + r2 * (-1. / 720. + r2 * (1.
+	 / 40320. + r2 * (-1. / 3628800. + r2 * (1. / 479001600. + r2 * (-1.
+	 / 87178291200.)))))));
+}
+
+// Writes x as r + quadrant * pi / 2, with r in [-pi / 4, pi / 4]
+static double Reduce(const double x, int &quadrant)
+{
+    const double k = std::floor(x * TWO_OVER_PI + .5);
+    quadrant = static_cast<int>(k - 4. * std::floor(k * .25));
+    return (x - k * HALF_PI_HIGH) - k * HALF_PI_LOW;
+}
+
+float Numeric::Sin(const float x)
+{
+    int quadrant;
+    const double r = Reduce(x, quadrant);
+    switch (quadrant) {
+    case 0:
+	return static_cast<float>(SinSeries(r));
+    case 1:
+	return static_cast<float>(CosSeries(r));
+    case 2:
+	return static_cast<float>(-SinSeries(r));
+    default:
+	return static_cast<float>(-CosSeries(r));
+    }
+}
+
+float Numeric::Cos(const float x)
+{
+    int quadrant;
+    const double r = Reduce(x, quadrant);
+    switch (quadrant) {
+    case 0:
+	return static_cast<float>(CosSeries(r));
+    case 1:
+	return static_cast<float>(-SinSeries(r));
+    case 2:
+	return static_cast<float>(-CosSeries(r));
+    default:
+	return static_cast<float>(SinSeries(r));
+    }
+}
+
+// Arc tangent, reduced to [-tan(pi / 12), tan(pi / 12)] where its series
+// converges quickly
+static double Atan(double t)
+{
+    const bool negative = t < 0.;
+    if (negative)
+	t = -t;
+    const bool inverted = t > 1.;
+    if (inverted)
+	t = 1. / t;
+
+    double base = 0.;
+    if (t > TAN_PI_12) {
+	t = (t * SQRT3 - 1.) / (t + SQRT3);
+	base = PI / 6.;
+    }
+
+    const double t2 = t * t;
+    double sum = 0.;
+    for (int n = 14; n >= 0; --n)
+	sum = 1. / (2 * n + 1) - t2 * sum;
+
+    double angle = base + t * sum;
+    if (inverted)
+	angle = HALF_PI - angle;
+    return negative ? -angle : angle;
+}
+
+static double Atan2(const double y, const double x)
+{
+    if (x > 0.)
+	return Atan(y / x);
+    if (x < 0.)
+	return y < 0. ? Atan(y / x) - PI : Atan(y / x) + PI;
+    return y > 0. ? HALF_PI : y < 0. ? -HALF_PI : 0.;
+}
+
+float Numeric::Acos(const float x)
+{
+    if (x >= 1.f)
+	return 0.f;
+    if (x <= -1.f)
+	return static_cast<float>(PI);
+    const double d = x;
+    return static_cast<float>(Atan2(std::sqrt((1. - d) * (1. + d)), d));
+}
+
+float Numeric::Atan2(const float y, const float x)
+{
+    return static_cast<float>(Podz::Atan2(y, x));
+}
+
+float Numeric::Exp(const float x)
+{
+    // Beyond these bounds the float result is infinite or zero anyway
+    if (x != x)
+	return x;
+    const double d = x > 200.f ? 200. : x < -200.f ? -200. : x;
+
+    // e^x = 2^k * e^r, with |r| <= ln(2) / 2
+    const double k = std::floor(d * LOG2_E + .5);
+    const double r = (d - k * LN2_HIGH) - k * LN2_LOW;
+    const double series = 1. + r * (1. + r * (1. / 2. + r * (1. / 6. + r
+	* (1. / 24. + r * (1. / 120. + r * (1. / 720. + r * (1. / 5040. + r
+	* (1. / 40320. + r * (1. / 362880. + r * (1. / 3628800. + r * (1.
+	/ 39916800. + r * (1. / 479001600. + r * (1. / 6227020800.)))))))))))));
+    return static_cast<float>(std::ldexp(series, static_cast<int>(k)));
+}
+
+} // namespace Podz
+
+#endif // PODZ_DETERMINISTIC
+
+// End of File
@@ -0,0 +1,67 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Numeric.h
+ * Description: Portable Math Functions (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_NUMERIC_H
+#define PODZ_NUMERIC_H
+
+#ifndef PODZ_DETERMINISTIC
+# include <cmath>
+#endif // !PODZ_DETERMINISTIC
+
+namespace Podz {
+
+// Transcendental functions used by the physics.  The C library ones differ
+// between systems in their last bits, so with --enable-deterministic they
+// are computed from basic IEEE operations only, which round the same way
+// everywhere; otherwise they are the usual (faster) library functions.
+class Numeric
+{
+public:
+#ifdef PODZ_DETERMINISTIC
+    static float Sin(const float x);
+    static float Cos(const float x);
+    static float Acos(const float x);
+    static float Atan2(const float y, const float x);
+    static float Exp(const float x);
+#else // !PODZ_DETERMINISTIC
+    static float Sin(const float x) { return sinf(x); }
+    static float Cos(const float x) { return cosf(x); }
+    static float Acos(const float x) { return acosf(x); }
+    static float Atan2(const float y, const float x) { return atan2f(y, x); }
+    static float Exp(const float x) { return expf(x); }
+#endif // !PODZ_DETERMINISTIC
+};
+
+} // namespace Podz
+
+#endif // !PODZ_NUMERIC_H
+
+// End of File
@@ -40,6 +40,8 @@
 
 // This module
 #include "Vector.h"
+#include "Basis.h"
+#include "Matrix.h"
 #include "Texture.h"
 #include "Object.h"
 
@@ -85,11 +87,24 @@ void Object::DisplayConst() {}
 void Object::DisplayVar() {}
 void Object::DisplayOSD() {}
 
+void Object::MoveTo(const Basis &basis)
+{
+    const float matrix[16] = {
+	basis.right.x,    basis.right.y,    basis.right.z,    0.f,
+	basis.up.x,       basis.up.y,       basis.up.z,       0.f,
+	basis.backward.x, basis.backward.y, basis.backward.z, 0.f,
+	basis.origin.x,   basis.origin.y,   basis.origin.z,   1.f
+    };
+
+    glMultMatrixf(matrix);
+}
+
 void Object::DrawTriangle(const Vector &point1, const Vector &point2,
 			  const Vector &point3, const Texture *texture,
 			  const float coord[6])
 {
-    Vector normal = ((point2 - point1) * (point3 - point1)) % 1;
+    Vector normal = (point2 - point1) * (point3 - point1);
+    VectorBatch::NormalizeFast(&normal, 1);
     glNormal3f(normal.x, normal.y, normal.z);
 
     if (texture)
@@ -125,7 +140,8 @@ void Object::DrawQuad(const Vector &point1, const Vector &point2,
 		      const Vector &point3, const Vector &point4,
 		      const Texture *texture, const float coord[8])
 {
-    Vector normal = ((point2 - point1) * (point4 - point1)) % 1;
+    Vector normal = (point2 - point1) * (point4 - point1);
+    VectorBatch::NormalizeFast(&normal, 1);
     glNormal3f(normal.x, normal.y, normal.z);
 
     if (texture)
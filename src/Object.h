@@ -35,6 +35,7 @@
 namespace Podz {
 
 class Vector;
+class Basis;
 class Texture;
 
 class Object
@@ -58,6 +59,9 @@ public:
 protected:
     Object();
 
+    // Multiply the current matrix to draw in the given (orthonormal) basis
+    static void MoveTo(const Basis &basis);
+
     static void DrawTriangle(const Vector &point1, const Vector &point2,
 			     const Vector &point3, const Texture *texture,
 			     const float coord[6]);
@@ -0,0 +1,305 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Optimizer.cpp
+ * Description: Racing Line Optimizer Program
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// Windows
+#ifdef _WIN32
+# define DIRSEP "\\"
+#else // !_WIN32
+# define DIRSEP "/"
+#endif // !_WIN32
+
+// STL
+#include <vector>
+#include <iostream>
+#include <string>
+
+// System
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+// This module
+#include "Clock.h"
+#include "Track.h"
+#include "Numeric.h"
+#include "Pod.h"
+#include "Pilot.h"
+#include "RacingLine.h"
+#include "ThreadPool.h"
+
+
+namespace Podz {
+
+// Candidate lines: the best one so far, moved towards one side around a
+// random node, over a random number of nodes
+static const float MAX_OFFSET = .9f;
+static const float MAX_BUMP = .3f;
+static const int MIN_WIDTH = 2, MAX_WIDTH = 12;
+
+// Lap time of a pilot following the line, in seconds, averaged over a
+// race from a standing start.  Lines are rated by the mean over several
+// pilots: the nominal one, and the first opponents, which drive it with
+// their own offset and pace.  A single pilot or lap would reward lines
+// that only work for it, and lose more elsewhere.
+static const int ROLLOUT_PILOTS = 6;
+
+static double GetLapTime(const Track &track, const RacingLine &line,
+			 const int pilot, const int rate)
+{
+    Pod pod(track);
+    Pilot *const driver = pilot == 0 ? new Pilot(track, 0.f, 1.f, &line)
+			  : Pilot::CreateOpponent(track, pilot - 1, &line);
+    const float dt = 1.f / static_cast<float>(rate);
+    // Slower rollouts are given up
+    const int ticks = Pod::LAP_NUM * Pod::MAX_LAP_TIME * rate;
+
+    double time = Pod::MAX_LAP_TIME;
+    for (int tick = 1; tick <= ticks; ++tick) {
+	pod.Step(driver->Decide(pod), dt);
+	if (pod.HasFinished()) {
+	    // The line is crossed within the tick: interpolate from the speed
+	    const float speed = pod.GetSpeed().Length() * dt;
+	    float late = speed > 0.f ? pod.GetLapPosition() / speed : 0.f;
+	    if (late > 1.f)
+		late = 1.f;
+	    time = (static_cast<double>(tick) - late) / rate / Pod::LAP_NUM;
+	    break;
+	}
+    }
+
+    delete driver;
+    return time;
+}
+
+// One rollout per line and pilot
+class RolloutTask : public ThreadPool::Task
+{
+public:
+    RolloutTask(const Track &trk, const std::vector<RacingLine> &lns,
+		std::vector<double> &tms, const int rt)
+	: track(trk), lines(lns), times(tms), rate(rt) {}
+
+    virtual void Run(const int index)
+    {
+	times[index] = GetLapTime(track, lines[index / ROLLOUT_PILOTS],
+				  index % ROLLOUT_PILOTS, rate);
+    }
+
+private:
+    const Track &track;
+    const std::vector<RacingLine> &lines;
+    std::vector<double> &times;
+    const int rate;
+
+    void operator =(const RolloutTask &) const;
+};
+
+// Mean lap time of each line, from the rollout times
+static double GetMean(const std::vector<double> &times, const int line)
+{
+    double sum = 0.;
+    for (int i = 0; i < ROLLOUT_PILOTS; ++i)
+	sum += times[line * ROLLOUT_PILOTS + i];
+    return sum / ROLLOUT_PILOTS;
+}
+
+// Same sequence on every machine: the result does not depend on the
+// number of threads
+static unsigned seed = 1;
+
+static float Random()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.f;
+}
+
+static void Perturb(RacingLine &line)
+{
+    const int count = line.GetCount();
+    const int centre = static_cast<int>(Random() * count);
+    const float width = MIN_WIDTH + Random() * (MAX_WIDTH - MIN_WIDTH);
+    const float bump = (Random() * 2.f - 1.f) * MAX_BUMP;
+
+    // Each node is moved once at most, even on short tracks
+    int reach = static_cast<int>(width * 2.f);
+    if (reach > (count - 1) / 2)
+	reach = (count - 1) / 2;
+    for (int i = -reach; i <= reach; ++i) {
+	const int node = ((centre + i) % count + count) % count;
+	const float x = static_cast<float>(i) / width;
+	float offset = line.GetNode(node) + bump * Numeric::Exp(-x * x);
+	if (offset < -MAX_OFFSET)
+	    offset = -MAX_OFFSET;
+	else if (offset > MAX_OFFSET)
+	    offset = MAX_OFFSET;
+	line.SetNode(node, offset);
+    }
+}
+
+static int Usage(const char *const name)
+{
+    std::cerr << "Usage: " << name
+	      << " [-j THREADS] [-r RATE] [-i ITERATIONS] [-k CANDIDATES]"
+		 " [-o LINE] [-z] [LEVEL]" << std::endl;
+    return EXIT_FAILURE;
+}
+
+static int Optimize(int argc, char **argv)
+{
+    int rate = 100, iterations = 100, candidates = 16, threads = 0;
+    bool centre = false;
+    const char *level = 0, *output = 0;
+
+    for (int i = 1; i < argc; ++i) {
+	if (argv[i][0] != '-' && level == 0)
+	    level = argv[i];
+	else if (std::strcmp(argv[i], "-z") == 0)
+	    centre = true;
+	else if (i + 1 >= argc)
+	    return Usage(argv[0]);
+	else if (std::strcmp(argv[i], "-j") == 0)
+	    threads = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-r") == 0)
+	    rate = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-i") == 0)
+	    iterations = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-k") == 0)
+	    candidates = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-o") == 0)
+	    output = argv[++i];
+	else
+	    return Usage(argv[0]);
+    }
+    if (rate <= 0 || iterations < 0 || candidates <= 0 || threads < 0)
+	return Usage(argv[0]);
+
+    // Default level: look in the same places as the game does
+    static const char *const levels[] = {
+#ifdef DATA_DIR
+	DATA_DIR DIRSEP "level.txt",
+#endif // DATA_DIR
+	"data" DIRSEP "level.txt", ".." DIRSEP "data" DIRSEP "level.txt"
+    };
+    ThreadPool pool(threads);
+    Track *track = 0;
+    if (level != 0)
+	track = new Track(level, &pool);
+    else {
+	for (unsigned i = 0; i < sizeof(levels) / sizeof(*levels); ++i) {
+	    delete track;
+	    track = new Track(level = levels[i], &pool);
+	    if (track->IsLoaded())
+		break;
+	}
+    }
+    if (!track->IsLoaded()) {
+	std::cerr << "Error: could not load level '" << level << "'."
+		  << std::endl;
+	delete track;
+	return EXIT_FAILURE;
+    }
+
+    // Going on from the current line of the level, unless told otherwise
+    const std::string file = output != 0 ? std::string(output)
+					 : RacingLine::GetFileName(level);
+    RacingLine best(*track);
+    if (!centre)
+	best.Load(RacingLine::GetFileName(level).c_str());
+
+    std::vector<RacingLine> lines(candidates, best);
+    std::vector<double> times(candidates * ROLLOUT_PILOTS);
+    RolloutTask task(*track, lines, times, rate);
+
+    pool.Run(task, ROLLOUT_PILOTS);
+    const double initial = GetMean(times, 0);
+    double bestTime = initial;
+    std::cout << "Level:         " << level << " (" << best.GetCount()
+	      << " nodes)\n"
+	      << "Initial lap:   " << initial << " s (mean of "
+	      << ROLLOUT_PILOTS << " pilots)" << std::endl;
+
+    const double start = Clock::GetTime();
+    int improvements = 0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+	for (int k = 0; k < candidates; ++k) {
+	    lines[k] = best;
+	    Perturb(lines[k]);
+	}
+	pool.Run(task, candidates * ROLLOUT_PILOTS);
+
+	int chosen = -1;
+	for (int k = 0; k < candidates; ++k) {
+	    const double time = GetMean(times, k);
+	    if (time < bestTime) {
+		bestTime = time;
+		chosen = k;
+	    }
+	}
+	if (chosen >= 0) {
+	    best = lines[chosen];
+	    ++improvements;
+	}
+    }
+    const double elapsed = Clock::GetTime() - start;
+
+    const int rollouts = iterations * candidates * ROLLOUT_PILOTS;
+    std::cout << "Optimized lap: " << bestTime << " s (" << improvements
+	      << " improvements in " << iterations << " iterations)\n"
+	      << "Rollouts:      " << rollouts << " in " << elapsed
+	      << " s on " << pool.GetThreadCount() << " threads ("
+	      << (elapsed > 0. ? rollouts / elapsed : 0.) << " /s)"
+	      << std::endl;
+
+    const bool saved = best.Save(file.c_str());
+    if (saved)
+	std::cout << "Saved:         '" << file << "'" << std::endl;
+    else
+	std::cerr << "Error: could not save racing line '" << file << "'."
+		  << std::endl;
+
+    delete track;
+    return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace Podz
+
+
+extern "C" int main(int argc, char **argv)
+{
+    return Podz::Optimize(argc, argv);
+}
+
+// End of File
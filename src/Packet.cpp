@@ -0,0 +1,118 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Packet.cpp
+ * Description: Network Packet
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// This module
+#include "Packet.h"
+
+
+namespace Podz {
+
+void Packet::Start(const Type type)
+{
+    size = 0;
+    error = false;
+    WriteByte(MAGIC);
+    WriteByte(VERSION);
+    WriteByte(type);
+}
+
+void Packet::WriteByte(const unsigned byte)
+{
+    if (size < MAX_SIZE)
+	data[size++] = static_cast<unsigned char>(byte);
+    else
+	error = true;
+}
+
+void Packet::WriteNumber(unsigned number)
+{
+    // Seven bits per byte, the high bit set on all bytes but the last one
+    while (number >= 0x80) {
+	WriteByte((number & 0x7f) | 0x80);
+	number >>= 7;
+    }
+    WriteByte(number);
+}
+
+void Packet::WriteSigned(const int number)
+{
+    // Zigzag encoding: small negative numbers stay short
+    const unsigned bits = static_cast<unsigned>(number);
+    WriteNumber(number < 0 ? ~(bits << 1) : bits << 1);
+}
+
+unsigned Packet::Open(const int length)
+{
+    size = length;
+    cursor = 0;
+    error = false;
+
+    if (ReadByte() != MAGIC || ReadByte() != VERSION)
+	return 0;
+    const unsigned type = ReadByte();
+    return error ? 0 : type;
+}
+
+unsigned Packet::ReadByte()
+{
+    if (cursor < size)
+	return data[cursor++];
+    error = true;
+    return 0;
+}
+
+unsigned Packet::ReadNumber()
+{
+    unsigned number = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+	const unsigned byte = ReadByte();
+	number |= (byte & 0x7f) << shift;
+	if ((byte & 0x80) == 0)
+	    return number;
+    }
+    error = true;
+    return 0;
+}
+
+int Packet::ReadSigned()
+{
+    const unsigned number = ReadNumber();
+    return static_cast<int>(number & 1 ? ~(number >> 1) : number >> 1);
+}
+
+} // namespace Podz
+
+// End of File
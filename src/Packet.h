@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Packet.h
+ * Description: Network Packet (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_PACKET_H
+#define PODZ_PACKET_H
+
+namespace Podz
+{
+
+// Datagram contents, written and read as bytes and variable-length
+// integers; reading past the end or a malformed number sets an error flag
+// instead of failing at once, so that messages are checked only once read
+class Packet
+{
+public:
+    // Small enough not to be fragmented on any network
+    enum { MAX_SIZE = 1200 };
+
+    // First bytes of every packet
+    enum { MAGIC = 0x50, VERSION = 4 };
+
+    // Message types
+    enum Type {
+	HELLO = 1, // Client: level hash and tick rate
+	WELCOME,   // Server: pod of the client
+	REFUSED,   // Server: full, or another level or rate
+	INPUT,     // Client: sequence, acknowledged tick, input
+	SNAPSHOT   // Server: tick, base tick, pods
+    };
+
+    Packet() : size(0), cursor(0), error(false) {}
+
+    // Writing
+    void Start(const Type type);
+    void WriteByte(const unsigned byte);
+    void WriteNumber(unsigned number);
+    void WriteSigned(const int number);
+
+    // Reading: the type of a valid packet, 0 otherwise
+    unsigned Open(const int length);
+    unsigned ReadByte();
+    unsigned ReadNumber();
+    int ReadSigned();
+    bool HasError() const { return error; }
+
+    unsigned char *GetData() { return data; }
+    const unsigned char *GetData() const { return data; }
+    int GetSize() const { return size; }
+
+private:
+    unsigned char data[MAX_SIZE];
+    int size, cursor;
+    bool error;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_PACKET_H
+
+// End of File
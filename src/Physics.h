@@ -0,0 +1,101 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Physics.h
+ * Description: Pod Physics Constants
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_PHYSICS_H
+#define PODZ_PHYSICS_H
+
+namespace Podz {
+
+// Physical constants, in circuit units and seconds, shared by the scalar
+// (Pod) and batched (PodBatch) implementations
+static const float GRAVITY = 10.f;             // Gravity (u/s^2)
+static const float BORDER = .1f;
+static const float GROUND_REACTION_TOUCH_FACTOR = 1.5f;
+static const float GROUND_REACTION_FACTOR = 1.f;
+static const float GROUND_REACTION_MAX = 4.f * GRAVITY;
+static const float GROUND_REACTION_HEIGHT_FACTOR = 3.f; // Of the levitation
+static const float REACTION_FACTOR = .5f;
+static const float REACTION_SPEED_FACTOR = .04f; // Per unit of speed (s/u)
+static const float REACTION_MIN = 1.f;
+static const float WRONG_WAY_SPEED = .1f;      // Backward speed (u/s)
+
+// Handling of each pod class.  The values are returned by inline functions
+// rather than stored, so that the physics templates instantiated for a
+// class fold them into their code like literals.
+struct StandardHandling {
+    static float Mass() { return 1.f; }            // Relative to the others
+    static float LevitHeight() { return .3f; }
+    static float Drag() { return .5013f; }         // Speed damping (1/s)
+    static float Accel() { return 5.f; }           // Thrust increase (u/s^3)
+    static float MaxAccel() { return 15.f; }       // Maximum thrust (u/s^2)
+    static float RotSpeed() { return 2.5f; }       // Turning speed (rad/s)
+    static float SlopeSpeed() { return 2.f; }      // Slope increase (rad/s)
+    static float SlopeDamping() { return 3.046f; } // Slope damping (1/s)
+    static float SlopeMax() { return 1.0471976f; } // Pi / 3
+};
+
+// Quick to spool up and to turn, but with less top thrust
+struct LightHandling : StandardHandling {
+    static float Mass() { return .7f; }
+    static float Drag() { return .55f; }
+    static float Accel() { return 6.5f; }
+    static float MaxAccel() { return 13.5f; }
+    static float RotSpeed() { return 2.9f; }
+    static float SlopeSpeed() { return 2.4f; }
+};
+
+// Slow to react, but faster on straights and pushing the others around
+struct HeavyHandling : StandardHandling {
+    static float Mass() { return 1.5f; }
+    static float LevitHeight() { return .35f; }
+    static float Drag() { return .47f; }
+    static float Accel() { return 4.f; }
+    static float MaxAccel() { return 16.5f; }
+    static float RotSpeed() { return 2.1f; }
+    static float SlopeSpeed() { return 1.6f; }
+    static float SlopeMax() { return .87266463f; } // Pi / 3.6
+};
+
+static const int MAX_SUBSTEPS = 64;
+
+// Pod hull, as drawn by Vehicle: box around the pod position, its center
+// slightly ahead of it
+static const float HULL_HALF_WIDTH = .4f;
+static const float HULL_HALF_LENGTH = .5f;
+static const float HULL_HALF_HEIGHT = .1f;
+static const float HULL_FORWARD = .05f;
+static const float HULL_RESTITUTION = .5f;     // Bounce between pods
+
+} // namespace Podz
+
+#endif // !PODZ_PHYSICS_H
+
+// End of File
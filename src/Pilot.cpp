@@ -0,0 +1,117 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Pilot.cpp
+ * Description: Computer Pod Driver
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Numeric.h"
+#include "Pod.h"
+#include "RacingLine.h"
+#include "Pilot.h"
+
+
+namespace Podz {
+
+// Steering: aim at a point of the track ahead, further at higher speed
+static const float AIM_DISTANCE = 3.f;
+static const float AIM_TIME = .25f;
+static const float STEER_TOLERANCE = .05f;
+
+// Throttle: look for the turns the pod will reach within that time, and
+// brake when going too fast for them
+static const float BRAKE_TIME = 1.f;
+static const float CORNER_SPEED = 12.f;
+static const float STEER_LIFT = .5f;
+
+Pilot::Pilot(const Track &trk, const float ln, const float pc,
+	     const RacingLine *const racing)
+    : track(trk), line(ln), pace(pc), racingLine(racing), cursor(0)
+{}
+
+Pilot *Pilot::CreateOpponent(const Track &trk, const int number,
+			     const RacingLine *const racing)
+{
+    // Spread opponents over three lines and four paces
+    return new Pilot(trk, static_cast<float>(number % 3 - 1) * .4f,
+		     .85f + static_cast<float>(number % 4) * .05f, racing);
+}
+
+unsigned Pilot::Decide(const Pod &pod)
+{
+    const Basis &basis = pod.GetBasis();
+    const float speed = pod.GetSpeed().Length();
+    const float position = pod.GetCircPosition();
+
+    // Steer towards the chosen line, in the track frame of the pod
+    const float aim = position + AIM_DISTANCE + speed * AIM_TIME;
+    const Basis target = track.GetBasis(aim, &cursor);
+    float offset = line;
+    if (racingLine != 0) {
+	offset += racingLine->GetOffset(aim);
+	offset = offset < -1.f ? -1.f : offset > 1.f ? 1.f : offset;
+    }
+    const Vector point = target.origin + target.right
+		       * (offset * track.GetWidth(aim, &cursor) * .5f);
+    const Vector local = basis.RevertVector(point - pod.GetPosition());
+    const float error = Numeric::Atan2(local.x, -local.z) - pod.GetAngle();
+
+    unsigned input = 0;
+    if (error < -STEER_TOLERANCE)
+	input |= Pod::INPUT_LEFT;
+    else if (error > STEER_TOLERANCE)
+	input |= Pod::INPUT_RIGHT;
+
+    // Turn sharpness ahead: angle between the current and upcoming frames
+    const Basis ahead = track.GetBasis(position + speed * BRAKE_TIME,
+				       &cursor);
+    const float bend = 1.f - basis.RevertVector(ahead.backward).z;
+    const float limit = CORNER_SPEED * pace / sqrtf(bend + 1e-3f);
+
+    if (speed > limit)
+	input |= Pod::INPUT_BRAKE;
+    else if (fabsf(error) < STEER_LIFT || speed < limit * .5f)
+	input |= Pod::INPUT_ACCELERATE;
+
+    return input;
+}
+
+} // namespace Podz
+
+// End of File
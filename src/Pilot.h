@@ -0,0 +1,77 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Pilot.h
+ * Description: Computer Pod Driver (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_PILOT_H
+#define PODZ_PILOT_H
+
+namespace Podz
+{
+
+class Track;
+class Pod;
+class RacingLine;
+
+// Computer driver: looks at the track ahead of a pod and chooses its
+// controls, the same way a player would with the keyboard
+class Pilot
+{
+public:
+    // line: preferred lateral offset, as a fraction of the half track width
+    // (-1 for the left border, 1 for the right one), from the racing line
+    // if any, the centre line otherwise; pace: cornering speed factor, 1
+    // being the nominal driver
+    Pilot(const Track &trk, const float line = 0.f, const float pace = 1.f,
+	  const RacingLine *const racing = 0);
+
+    // Input bit mask (Pod::Input) for the next tick; only reads the pod, so
+    // that pilots of different pods may decide in parallel
+    unsigned Decide(const Pod &pod);
+
+    // Pilot of the given opponent (from 0), the same in every program so
+    // that races can be simulated again
+    static Pilot *CreateOpponent(const Track &trk, const int number,
+				 const RacingLine *const racing = 0);
+
+private:
+    const Track &track;
+    float line, pace;
+    const RacingLine *racingLine;
+    int cursor; // Segment lookup hint for the track
+
+    // No assignment
+    void operator =(const Pilot &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_PILOT_H
+
+// End of File
@@ -0,0 +1,363 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Pod.cpp
+ * Description: Pod Physics
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cstring>
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Physics.h"
+#include "Numeric.h"
+#include "Checksum.h"
+#include "Pod.h"
+
+
+namespace Podz {
+
+// What a pod needs to know about its class, out of the simulation loop
+struct ClassInfo {
+    const char *name;
+    float levitHeight;
+};
+
+static const ClassInfo classes[Pod::CLASS_NUM] = {
+    { "standard", StandardHandling::LevitHeight() },
+    { "light", LightHandling::LevitHeight() },
+    { "heavy", HeavyHandling::LevitHeight() }
+};
+
+Pod::Pod(const Track &trk, const Class cls)
+    : track(trk), podClass(cls), startPosition(0.f), startOffset(0.f),
+      levitHeight(classes[cls].levitHeight)
+{
+    Init();
+}
+
+const char *Pod::GetClassName(const Class cls)
+{
+    return classes[cls].name;
+}
+
+float Pod::GetMass() const
+{
+    switch (podClass) {
+    case CLASS_LIGHT:
+	return LightHandling::Mass();
+
+    case CLASS_HEAVY:
+	return HeavyHandling::Mass();
+
+    default:
+	return StandardHandling::Mass();
+    }
+}
+
+bool Pod::FindClass(const char *const name, Class &cls)
+{
+    for (int i = 0; i < CLASS_NUM; ++i) {
+	if (std::strcmp(name, classes[i].name) == 0) {
+	    cls = static_cast<Class>(i);
+	    return true;
+	}
+    }
+    return false;
+}
+
+void Pod::SetStart(const float position, const float offset)
+{
+    startPosition = position;
+    startOffset = offset;
+}
+
+void Pod::Init()
+{
+    circCursor = 0;
+    basis = track.GetBasis(startPosition, &circCursor);
+    position = basis.origin + basis.up * levitHeight / 2.f
+	     + basis.right * startOffset;
+    direction = -basis.backward;
+    speed.Set(0.f, 0.f, 0.f);
+    // Starting behind the line: the first lap begins when crossing it
+    circPosition = startPosition;
+    lapPosition = startPosition;
+    circOffset = 0.f;
+    acceleration = 0.f;
+    angle = 0.f;
+    slope = 0.f;
+
+    accelerated = false;
+    wrongWay = false;
+    lap = 1;
+
+}
+
+void Pod::Save(State &state) const
+{
+    state.basis = basis;
+    state.position = position;
+    state.direction = direction;
+    state.speed = speed;
+    state.circPosition = circPosition;
+    state.lapPosition = lapPosition;
+    state.circCursor = circCursor;
+    state.circOffset = circOffset;
+    state.acceleration = acceleration;
+    state.angle = angle;
+    state.slope = slope;
+    state.accelerated = accelerated;
+    state.wrongWay = wrongWay;
+    state.lap = lap;
+}
+
+void Pod::Restore(const State &state)
+{
+    basis = state.basis;
+    position = state.position;
+    direction = state.direction;
+    speed = state.speed;
+    circPosition = state.circPosition;
+    lapPosition = state.lapPosition;
+    circCursor = state.circCursor;
+    circOffset = state.circOffset;
+    acceleration = state.acceleration;
+    angle = state.angle;
+    slope = state.slope;
+    accelerated = state.accelerated;
+    wrongWay = state.wrongWay;
+    lap = state.lap;
+}
+
+unsigned Pod::GetChecksum(const unsigned seed) const
+{
+    // Field by field, not to depend on padding; the basis rotation and matrix
+    // derive from its vectors
+    const Vector *const vectors[7] = {
+	&basis.origin, &basis.right, &basis.up, &basis.backward,
+	&position, &direction, &speed
+    };
+    unsigned words[7 * 3 + 10];
+    unsigned *word = words;
+    for (int i = 0; i < 7; ++i) {
+	*word++ = Checksum::GetBits(vectors[i]->x);
+	*word++ = Checksum::GetBits(vectors[i]->y);
+	*word++ = Checksum::GetBits(vectors[i]->z);
+    }
+    *word++ = Checksum::GetBits(circPosition);
+    *word++ = Checksum::GetBits(lapPosition);
+    *word++ = Checksum::GetBits(circOffset);
+    *word++ = Checksum::GetBits(acceleration);
+    *word++ = Checksum::GetBits(angle);
+    *word++ = Checksum::GetBits(slope);
+    *word++ = static_cast<unsigned>(circCursor);
+    *word++ = static_cast<unsigned>(lap);
+    *word++ = accelerated ? 1u : 0u;
+    *word++ = wrongWay ? 1u : 0u;
+
+    return Checksum::Compute(words, sizeof(words), seed);
+}
+
+void Pod::Step(const unsigned input, const float dt)
+{
+    switch (podClass) {
+    case CLASS_LIGHT:
+	StepClass<LightHandling>(input, dt);
+	break;
+
+    case CLASS_HEAVY:
+	StepClass<HeavyHandling>(input, dt);
+	break;
+
+    default:
+	StepClass<StandardHandling>(input, dt);
+	break;
+    }
+}
+
+template <class Handling>
+void Pod::StepClass(const unsigned input, const float dt)
+{
+    BeginStep();
+
+    if (input & INPUT_ACCELERATE) {
+	accelerated = true;
+	acceleration += Handling::Accel() * dt;
+	if (acceleration > Handling::MaxAccel())
+	    acceleration = Handling::MaxAccel();
+    }
+    if (input & INPUT_BRAKE)
+	Decelerate(Handling::Accel() * 4.f * dt);
+    if (input & INPUT_LEFT) {
+	angle -= Handling::RotSpeed() * dt;
+	if ((slope += Handling::SlopeSpeed() * dt) > Handling::SlopeMax())
+	    slope = Handling::SlopeMax();
+    }
+    if (input & INPUT_RIGHT) {
+	angle += Handling::RotSpeed() * dt;
+	if ((slope -= Handling::SlopeSpeed() * dt) < -Handling::SlopeMax())
+	    slope = -Handling::SlopeMax();
+    }
+
+    Move<Handling>(dt);
+}
+
+template <class Handling>
+void Pod::Move(const float dt)
+{
+    // Split the step so that the vehicle never travels more than a border
+    // width at once: the border test is discrete, and a longer move could
+    // tunnel through the border
+    const float maxDistance = Track::GetBorderWidth();
+    int substeps = static_cast<int>(ceilf(speed.Length() * dt /
+					  maxDistance));
+    if (substeps < 1)
+	substeps = 1;
+    else if (substeps > MAX_SUBSTEPS)
+	substeps = MAX_SUBSTEPS;
+
+    const float subdt = dt / static_cast<float>(substeps);
+    for (int i = 0; i < substeps; ++i)
+	Integrate<Handling>(subdt);
+
+    if (accelerated)
+	accelerated = false;
+    else
+	Decelerate(Handling::Accel() / 2.f * dt);
+    slope *= Numeric::Exp(-Handling::SlopeDamping() * dt);
+}
+
+template <class Handling>
+void Pod::Integrate(const float dt)
+{
+    const Vector localpos = basis.RevertPoint(position);
+    const Vector localspeed = basis.RevertVector(speed);
+
+    direction = basis.TransformVector(Vector(0.f, 0.f, -1.f)
+		.Rotate(0.f, angle, 0.f));
+
+    speed = speed * Numeric::Exp(-Handling::Drag() * dt)
+	  + (direction * acceleration + Vector(0.f, -GRAVITY, 0.f)) * dt;
+
+    const float heightMax = Handling::LevitHeight()
+			  * GROUND_REACTION_HEIGHT_FACTOR;
+    float ground = 0.f;
+    if (localpos.y < 0) {
+	position.AddScaled(basis.up, -localpos.y);
+	ground = localspeed.y * -GROUND_REACTION_TOUCH_FACTOR;
+    } else if (localpos.y < heightMax) {
+	const float height = Handling::LevitHeight() / GROUND_REACTION_FACTOR;
+	if (localpos.y <= height)
+	    ground = GROUND_REACTION_MAX - localpos.y * ((GROUND_REACTION_MAX
+		    - GRAVITY) / height);
+	else
+	    ground = GRAVITY - (localpos.y - height) * (GRAVITY /
+		    (heightMax - height));
+	ground *= GROUND_REACTION_FACTOR * dt;
+    }
+    speed.AddScaled(basis.up, ground);
+
+    const float diff = fabsf(localpos.x)
+		     - (track.GetWidth(circPosition, &circCursor) * .5f
+			+ track.GetBorderSlope() * localpos.y - BORDER);
+    if (diff > 0) {
+	position.AddScaled(basis.right, 2.f * (localpos.x < 0 ? diff : -diff));
+	const float min = REACTION_MIN * speed.Length();
+	float reaction = localspeed.x * -REACTION_FACTOR;
+	if (fabsf(reaction) < min)
+	    reaction = localspeed.x < 0 ? min : -min;
+	speed *= REACTION_SPEED_FACTOR * fabsf(localspeed.x);
+	speed += basis.right * reaction * REACTION_FACTOR;
+	acceleration *= .5f;
+    }
+
+    position.AddScaled(speed, dt);
+
+    const Vector newpos = basis.RevertPoint(position);
+    circOffset += newpos.x;
+    if (newpos.z != 0.f) {
+	const float circAdd = -newpos.z;
+	wrongWay = circAdd < -WRONG_WAY_SPEED * dt;
+	circPosition += circAdd;
+	lapPosition += circAdd;
+
+	const Vector oldright = basis.right;
+	basis = track.GetBasis(circPosition, &circCursor);
+
+	const Vector newright = basis.RevertVector(oldright);
+	if (newright.x < 1.f) {
+	    if (newright.z > 0.f)
+		angle += Numeric::Acos(newright.x);
+	    else if (newright.z < 0.f)
+		angle -= Numeric::Acos(newright.x);
+	}
+    } else
+	wrongWay = false;
+
+    if (lapPosition >= track.GetTotalLength()) {
+	lapPosition -= track.GetTotalLength();
+	++lap;
+    }
+}
+
+void Pod::Bump(const Vector &offset, const Vector &impulse)
+{
+    // The track position follows on the next move
+    position += offset;
+    speed += impulse;
+}
+
+void Pod::Decelerate(const float amount)
+{
+    if (acceleration > 0.f) {
+	acceleration -= amount;
+	if (acceleration < 0.f)
+	    acceleration = 0.f;
+    }
+}
+
+// For the callers stepping pods grouped by class
+template void Pod::StepClass<StandardHandling>(const unsigned input,
+					       const float dt);
+template void Pod::StepClass<LightHandling>(const unsigned input,
+					    const float dt);
+template void Pod::StepClass<HeavyHandling>(const unsigned input,
+					    const float dt);
+
+} // namespace Podz
+
+// End of File
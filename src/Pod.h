@@ -0,0 +1,158 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Pod.h
+ * Description: Pod Physics (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_POD_H
+#define PODZ_POD_H
+
+#include "Vector.h"
+#include "Basis.h"
+
+namespace Podz
+{
+
+class Track;
+
+// Pod physics, without any rendering
+class Pod
+{
+public:
+    // Controls, as a bit mask
+    enum Input {
+	INPUT_ACCELERATE = 1 << 0,
+	INPUT_BRAKE      = 1 << 1,
+	INPUT_LEFT       = 1 << 2,
+	INPUT_RIGHT      = 1 << 3,
+	INPUT_MASK       = (1 << 4) - 1
+    };
+
+    // Laps in a race, and time past which a lap counts as given up, in
+    // seconds
+    enum { LAP_NUM = 3, MAX_LAP_TIME = 120 };
+
+    // Pod classes, each with its own handling (see Physics.h)
+    enum Class {
+	CLASS_STANDARD,
+	CLASS_LIGHT,
+	CLASS_HEAVY,
+	CLASS_NUM
+    };
+
+    // Whole simulation state, plain data copied at once by snapshots
+    struct State {
+	Basis basis;
+	Vector position, direction, speed;
+	float circPosition, lapPosition;
+	int circCursor;
+	float circOffset, acceleration, angle, slope;
+	bool accelerated, wrongWay;
+	int lap;
+    };
+
+    Pod(const Track &trk, const Class cls = CLASS_STANDARD);
+    virtual ~Pod() {}
+
+    // Starting place: track position and lateral offset, used by Init()
+    void SetStart(const float position, const float offset);
+
+    // Simulation, dt being the time step in seconds.  Step() dispatches on
+    // the pod class; callers holding pods grouped by class rather call the
+    // StepClass() of each group, with the handling of its class (see
+    // Physics.h) folded in at compile time.
+    virtual void Init();
+    void Step(const unsigned input, const float dt);
+    template <class Handling> void StepClass(const unsigned input,
+					     const float dt);
+    void Save(State &state) const;
+    virtual void Restore(const State &state);
+
+    // Hash of the exact simulation state, to detect divergences
+    unsigned GetChecksum(const unsigned seed = 0) const;
+
+    // Collision response: the pod is moved and its speed changed at once
+    void Bump(const Vector &offset, const Vector &impulse);
+
+    Class GetClass() const { return podClass; }
+    float GetMass() const; // From the handling of the class
+    static const char *GetClassName(const Class cls);
+    static bool FindClass(const char *const name, Class &cls);
+
+    const Basis &GetBasis() const { return basis; }
+    const Vector &GetPosition() const { return position; }
+    const Vector &GetDirection() const { return direction; }
+    const Vector &GetSpeed() const { return speed; }
+    float GetCircPosition() const { return circPosition; }
+    float GetLapPosition() const { return lapPosition; }
+    float GetAngle() const { return angle; }
+    float GetAcceleration() const { return acceleration; }
+    float GetSlope() const { return slope; }
+    int GetLap() const { return lap; }
+    bool IsAccelerated() const { return accelerated; }
+    bool IsWrongWay() const { return wrongWay; }
+    bool HasFinished() const { return lap > LAP_NUM; }
+
+protected:
+    const Track &track;
+    const Class podClass;
+    float startPosition, startOffset;
+
+    Basis basis;
+    Vector position, direction;
+    Vector speed;
+    float circPosition, lapPosition;
+    int circCursor; // Segment lookup hint for the track
+    float circOffset;
+    float acceleration;
+    float angle;
+    float slope;
+
+    bool accelerated;
+    bool wrongWay;
+    int lap;
+
+    // Called at the start of every step, through either entry point
+    virtual void BeginStep() {}
+
+private:
+    float levitHeight;
+
+    template <class Handling> void Move(const float dt);
+    template <class Handling> void Integrate(const float dt);
+    void Decelerate(const float amount);
+
+    // No assignment
+    void operator =(const Pod &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_POD_H
+
+// End of File
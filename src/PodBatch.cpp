@@ -0,0 +1,376 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/PodBatch.cpp
+ * Description: Batched Pod Physics
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <algorithm>
+
+// System
+#include <cstddef>
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Physics.h"
+#include "Numeric.h"
+#include "Simd.h"
+#include "Pod.h"
+#include "PodBatch.h"
+
+
+namespace Podz {
+
+// The batch only simulates standard pods
+static const float LEVIT_HEIGHT = StandardHandling::LevitHeight();
+static const float DRAG = StandardHandling::Drag();
+static const float ACCEL = StandardHandling::Accel();
+static const float MAX_ACCEL = StandardHandling::MaxAccel();
+static const float ROT_SPEED = StandardHandling::RotSpeed();
+static const float SLOPE_SPEED = StandardHandling::SlopeSpeed();
+static const float SLOPE_DAMPING = StandardHandling::SlopeDamping();
+static const float SLOPE_MAX = StandardHandling::SlopeMax();
+static const float GROUND_REACTION_HEIGHT_MAX =
+    LEVIT_HEIGHT * GROUND_REACTION_HEIGHT_FACTOR;
+
+PodBatch::PodBatch(const Track &trk, const int nb)
+    : track(trk), count(nb), stride((nb + 3) & ~3)
+{
+    // Every field array is 16-byte aligned, and padded to a multiple of four
+    // pods; padding pods are simulated along with the others, never steered
+    buffer = new float[FIELD_NUM * stride + 3];
+    float *aligned = buffer;
+    while ((reinterpret_cast<std::size_t>(aligned) & 15) != 0)
+	++aligned;
+    for (int i = 0; i < FIELD_NUM; ++i)
+	fields[i] = aligned + i * stride;
+
+    laps = new int[stride];
+    cursors = new int[stride];
+    inputs = new unsigned[stride];
+
+    Init();
+}
+
+PodBatch::~PodBatch()
+{
+    delete[] buffer;
+    delete[] laps;
+    delete[] cursors;
+    delete[] inputs;
+}
+
+bool PodBatch::HasFinished(const int pod) const
+{
+    return laps[pod] > Pod::LAP_NUM;
+}
+
+void PodBatch::Init()
+{
+    const Mask4 all(true, true, true, true);
+    for (int i = 0; i < stride; ++i) {
+	cursors[i] = 0;
+	fields[CIRC_POSITION][i] = 0.f;
+    }
+    for (int first = 0; first < stride; first += 4)
+	LoadFrames(first, all);
+
+    for (int i = 0; i < stride; ++i) {
+	const Vector position(
+	    fields[ORIGIN_X][i] + fields[UP_X][i] * LEVIT_HEIGHT / 2.f,
+	    fields[ORIGIN_Y][i] + fields[UP_Y][i] * LEVIT_HEIGHT / 2.f,
+	    fields[ORIGIN_Z][i] + fields[UP_Z][i] * LEVIT_HEIGHT / 2.f);
+	fields[POS_X][i] = position.x;
+	fields[POS_Y][i] = position.y;
+	fields[POS_Z][i] = position.z;
+	fields[SPEED_X][i] = fields[SPEED_Y][i] = fields[SPEED_Z][i] = 0.f;
+	fields[LAP_POSITION][i] = 0.f;
+	fields[CIRC_OFFSET][i] = 0.f;
+	fields[ACCELERATION][i] = 0.f;
+	fields[ANGLE][i] = 0.f;
+	fields[SLOPE][i] = 0.f;
+	fields[ACCELERATED][i] = 0.f;
+	fields[WRONG_WAY][i] = 0.f;
+
+	laps[i] = 1;
+	inputs[i] = 0;
+    }
+}
+
+void PodBatch::LoadFrames(const int first, const Mask4 &lanes)
+{
+    // The track writes the components in the order of the fields, of which
+    // only the given lanes are kept
+    float frames[Track::FRAME_NUM][4];
+    float *targets[Track::FRAME_NUM];
+    for (int i = 0; i < Track::FRAME_NUM; ++i)
+	targets[i] = frames[i];
+    track.GetFrames(fields[CIRC_POSITION] + first, 4, targets,
+		    cursors + first);
+
+    for (int i = 0; i < Track::FRAME_NUM; ++i)
+	Set(static_cast<Field>(ORIGIN_X + i), first,
+	    Float4::LoadUnaligned(frames[i]), lanes);
+}
+
+void PodBatch::Step(const unsigned *const in, const float dt)
+{
+    std::copy(in, in + count, inputs);
+
+    for (int first = 0; first < stride; first += 4) {
+	Control(first, dt);
+	Move(first, dt);
+    }
+}
+
+void PodBatch::Control(const int first, const float dt)
+{
+    const unsigned *const input = inputs + first;
+    const Mask4 all(true, true, true, true);
+    const Float4 zero(0.f);
+
+    // Same as Pod::Accelerate, Pod::Brake, Pod::TurnLeft and Pod::TurnRight
+    Float4 acceleration = Get(ACCELERATION, first);
+    const Mask4 accelerate = Mask4::Test(input, Pod::INPUT_ACCELERATE);
+    acceleration = Select(accelerate,
+			  Min(acceleration + Float4(ACCEL * dt), MAX_ACCEL),
+			  acceleration);
+    Set(ACCELERATED, first, 1.f, accelerate);
+
+    const Mask4 brake = Mask4::Test(input, Pod::INPUT_BRAKE)
+		      & (acceleration > zero);
+    acceleration = Select(brake,
+			  Max(acceleration - Float4(ACCEL * 4.f * dt), zero),
+			  acceleration);
+    Set(ACCELERATION, first, acceleration, all);
+
+    Float4 angle = Get(ANGLE, first), slope = Get(SLOPE, first);
+    const Mask4 left = Mask4::Test(input, Pod::INPUT_LEFT);
+    angle = Select(left, angle - Float4(ROT_SPEED * dt), angle);
+    slope = Select(left, Min(slope + Float4(SLOPE_SPEED * dt), SLOPE_MAX),
+		   slope);
+    const Mask4 right = Mask4::Test(input, Pod::INPUT_RIGHT);
+    angle = Select(right, angle + Float4(ROT_SPEED * dt), angle);
+    slope = Select(right, Max(slope - Float4(SLOPE_SPEED * dt), -SLOPE_MAX),
+		   slope);
+    Set(ANGLE, first, angle, all);
+    Set(SLOPE, first, slope, all);
+}
+
+void PodBatch::Move(const int first, const float dt)
+{
+    // Same substepping as Pod::Move, each pod having its own count
+    const float maxDistance = Track::GetBorderWidth();
+    int substeps[4], maxSubsteps = 1;
+    float subdt[4], drag[4];
+
+    for (int i = 0; i < 4; ++i) {
+	const Vector speed = GetSpeed(first + i);
+	int n = static_cast<int>(ceilf(speed.Length() * dt / maxDistance));
+	if (n < 1)
+	    n = 1;
+	else if (n > MAX_SUBSTEPS)
+	    n = MAX_SUBSTEPS;
+
+	substeps[i] = n;
+	maxSubsteps = std::max(maxSubsteps, n);
+	subdt[i] = dt / static_cast<float>(n);
+	drag[i] = Numeric::Exp(-DRAG * subdt[i]);
+    }
+
+    const Float4 vsubdt(subdt[0], subdt[1], subdt[2], subdt[3]);
+    const Float4 vdrag(drag[0], drag[1], drag[2], drag[3]);
+
+    for (int step = 0; step < maxSubsteps; ++step)
+	Integrate(first, vsubdt, vdrag,
+		  Mask4(step < substeps[0], step < substeps[1],
+			step < substeps[2], step < substeps[3]));
+
+    // Throttle release and slope return, once per step
+    const Mask4 all(true, true, true, true);
+    const Float4 zero(0.f);
+    const Float4 acceleration = Get(ACCELERATION, first);
+    const Mask4 released = ~(Get(ACCELERATED, first) != zero)
+			 & (acceleration > zero);
+    Set(ACCELERATION, first,
+	Max(acceleration - Float4(ACCEL / 2.f * dt), zero), released);
+    Set(ACCELERATED, first, zero, all);
+    Set(SLOPE, first,
+	Get(SLOPE, first) * Numeric::Exp(-SLOPE_DAMPING * dt), all);
+}
+
+void PodBatch::Integrate(const int first, const Float4 &dt,
+			 const Float4 &drag, const Mask4 &active)
+{
+    const Float4 zero(0.f);
+    const Float4 ox = Get(ORIGIN_X, first), oy = Get(ORIGIN_Y, first),
+		 oz = Get(ORIGIN_Z, first);
+    const Float4 rx = Get(RIGHT_X, first), ry = Get(RIGHT_Y, first),
+		 rz = Get(RIGHT_Z, first);
+    const Float4 ux = Get(UP_X, first), uy = Get(UP_Y, first),
+		 uz = Get(UP_Z, first);
+    const Float4 bx = Get(BACKWARD_X, first), by = Get(BACKWARD_Y, first),
+		 bz = Get(BACKWARD_Z, first);
+
+    Float4 px = Get(POS_X, first), py = Get(POS_Y, first),
+	   pz = Get(POS_Z, first);
+    Float4 vx = Get(SPEED_X, first), vy = Get(SPEED_Y, first),
+	   vz = Get(SPEED_Z, first);
+    Float4 acceleration = Get(ACCELERATION, first);
+
+    // Local position and speed in the track frame, the inverse of the
+    // orthonormal frame being its transpose
+    Float4 dx = px - ox, dy = py - oy, dz = pz - oz;
+    const Float4 lpx = rx * dx + ry * dy + rz * dz;
+    const Float4 lpy = ux * dx + uy * dy + uz * dz;
+    const Float4 lsx = rx * vx + ry * vy + rz * vz;
+    const Float4 lsy = ux * vx + uy * vy + uz * vz;
+
+    // Heading, rotated by the pod angle in the track frame
+    const Float4 angle = Get(ANGLE, first);
+    const Float4 sine(Numeric::Sin(angle.Get(0)),
+		      Numeric::Sin(angle.Get(1)),
+		      Numeric::Sin(angle.Get(2)),
+		      Numeric::Sin(angle.Get(3)));
+    const Float4 cosine(Numeric::Cos(angle.Get(0)),
+			Numeric::Cos(angle.Get(1)),
+			Numeric::Cos(angle.Get(2)),
+			Numeric::Cos(angle.Get(3)));
+    const Float4 hx = rx * sine - bx * cosine, hy = ry * sine - by * cosine,
+		 hz = rz * sine - bz * cosine;
+
+    vx = vx * drag + hx * acceleration * dt;
+    vy = vy * drag + (hy * acceleration - Float4(GRAVITY)) * dt;
+    vz = vz * drag + hz * acceleration * dt;
+
+    // Ground reaction
+    const float height = LEVIT_HEIGHT / GROUND_REACTION_FACTOR;
+    const Mask4 below = lpy < zero;
+    const Mask4 near = ~below & (lpy < GROUND_REACTION_HEIGHT_MAX);
+    const Float4 lift = Select(below, -lpy, zero);
+    px = px + ux * lift, py = py + uy * lift, pz = pz + uz * lift;
+
+    const Float4 levitation = Select(lpy <= height,
+	Float4(GROUND_REACTION_MAX) - lpy *
+	    ((GROUND_REACTION_MAX - GRAVITY) / height),
+	Float4(GRAVITY) - (lpy - Float4(height)) *
+	    (GRAVITY / (GROUND_REACTION_HEIGHT_MAX - height)));
+    const Float4 ground = Select(below,
+	lsy * -GROUND_REACTION_TOUCH_FACTOR,
+	Select(near, levitation * dt * GROUND_REACTION_FACTOR, zero));
+    vx = vx + ux * ground, vy = vy + uy * ground, vz = vz + uz * ground;
+
+    // Border reaction
+    const Float4 diff = Abs(lpx) - (Get(WIDTH, first) * .5f +
+				    lpy * Track::GetBorderSlope() - BORDER);
+    const Mask4 hit = diff > zero;
+    if (hit.Any()) {
+	const Float4 push = Select(hit,
+	    Select(lpx < zero, diff, -diff) * 2.f, zero);
+	px = px + rx * push, py = py + ry * push, pz = pz + rz * push;
+
+	const Float4 min = Sqrt(vx * vx + vy * vy + vz * vz) * REACTION_MIN;
+	Float4 reaction = lsx * -REACTION_FACTOR;
+	reaction = Select(Abs(reaction) < min,
+			  Select(lsx < zero, min, -min), reaction);
+	const Float4 factor = Abs(lsx) * REACTION_SPEED_FACTOR;
+	reaction = reaction * REACTION_FACTOR;
+	vx = Select(hit, vx * factor + rx * reaction, vx);
+	vy = Select(hit, vy * factor + ry * reaction, vy);
+	vz = Select(hit, vz * factor + rz * reaction, vz);
+	acceleration = Select(hit, acceleration * .5f, acceleration);
+    }
+
+    px = px + vx * dt, py = py + vy * dt, pz = pz + vz * dt;
+
+    // Progress along the track, in the frame used so far
+    dx = px - ox, dy = py - oy, dz = pz - oz;
+    const Float4 nx = rx * dx + ry * dy + rz * dz;
+    const Float4 nz = bx * dx + by * dy + bz * dz;
+    const Mask4 moved = nz != zero;
+    const Float4 progress = Select(moved, -nz, zero);
+    const Mask4 wrongWay = moved & (progress < -Float4(WRONG_WAY_SPEED) * dt);
+
+    Set(POS_X, first, px, active);
+    Set(POS_Y, first, py, active);
+    Set(POS_Z, first, pz, active);
+    Set(SPEED_X, first, vx, active);
+    Set(SPEED_Y, first, vy, active);
+    Set(SPEED_Z, first, vz, active);
+    Set(ACCELERATION, first, acceleration, active);
+    Set(CIRC_OFFSET, first, Get(CIRC_OFFSET, first) + nx, active);
+    Set(CIRC_POSITION, first, Get(CIRC_POSITION, first) + progress, active);
+    Set(LAP_POSITION, first, Get(LAP_POSITION, first) + progress, active);
+    Set(WRONG_WAY, first, Select(wrongWay, 1.f, zero), active);
+
+    // New track frame where the pods moved, keeping their heading when the
+    // track turns: the old right vector in the new frame
+    const Mask4 updated = active & moved;
+    const int update = updated.Bits(), lapping = active.Bits();
+    Float4 turnx(1.f), turnz(0.f);
+    if (update != 0) {
+	LoadFrames(first, updated);
+	turnx = Get(RIGHT_X, first) * rx + Get(RIGHT_Y, first) * ry
+	      + Get(RIGHT_Z, first) * rz;
+	turnz = Get(BACKWARD_X, first) * rx + Get(BACKWARD_Y, first) * ry
+	      + Get(BACKWARD_Z, first) * rz;
+    }
+
+    // Angles and lap counting cannot be vectorized
+    const float totalLength = track.GetTotalLength();
+    for (int i = 0; i < 4; ++i) {
+	const int pod = first + i;
+
+	if (update >> i & 1) {
+	    const float x = turnx.Get(i), z = turnz.Get(i);
+	    if (x < 1.f) {
+		if (z > 0.f)
+		    fields[ANGLE][pod] += Numeric::Acos(x);
+		else if (z < 0.f)
+		    fields[ANGLE][pod] -= Numeric::Acos(x);
+	    }
+	}
+
+	if ((lapping >> i & 1) && fields[LAP_POSITION][pod] >= totalLength) {
+	    fields[LAP_POSITION][pod] -= totalLength;
+	    ++laps[pod];
+	}
+    }
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,121 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/PodBatch.h
+ * Description: Batched Pod Physics (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_PODBATCH_H
+#define PODZ_PODBATCH_H
+
+#include "Vector.h"
+#include "Simd.h"
+
+namespace Podz
+{
+
+class Track;
+
+// Physics of many pods at once: the same model as Pod, with the state of
+// all pods stored as structure of arrays and stepped four pods at a time
+class PodBatch
+{
+public:
+    PodBatch(const Track &trk, const int nb);
+    ~PodBatch();
+
+    int GetCount() const { return count; }
+
+    // Simulation, with one input bit mask (see Pod::Input) per pod
+    void Init();
+    void Step(const unsigned *const inputs, const float dt);
+
+    Vector GetPosition(const int pod) const
+	{ return GetVector(POS_X, pod); }
+    Vector GetSpeed(const int pod) const
+	{ return GetVector(SPEED_X, pod); }
+    float GetCircPosition(const int pod) const
+	{ return fields[CIRC_POSITION][pod]; }
+    float GetLapPosition(const int pod) const
+	{ return fields[LAP_POSITION][pod]; }
+    int GetLap(const int pod) const { return laps[pod]; }
+    bool IsWrongWay(const int pod) const
+	{ return fields[WRONG_WAY][pod] != 0.f; }
+    bool HasFinished(const int pod) const;
+
+private:
+    enum Field {
+	POS_X = 0, POS_Y, POS_Z,
+	SPEED_X, SPEED_Y, SPEED_Z,
+	CIRC_POSITION, LAP_POSITION, CIRC_OFFSET,
+	ACCELERATION, ANGLE, SLOPE,
+	ACCELERATED, WRONG_WAY,
+
+	// Cached track frame and width at the current position
+	ORIGIN_X, ORIGIN_Y, ORIGIN_Z,
+	RIGHT_X, RIGHT_Y, RIGHT_Z,
+	UP_X, UP_Y, UP_Z,
+	BACKWARD_X, BACKWARD_Y, BACKWARD_Z,
+	WIDTH,
+
+	FIELD_NUM
+    };
+
+    const Track &track;
+    int count, stride;
+
+    float *buffer;
+    float *fields[FIELD_NUM];
+    int *laps, *cursors;
+    unsigned *inputs;
+
+    Float4 Get(const Field field, const int first) const
+	{ return Float4::Load(fields[field] + first); }
+    void Set(const Field field, const int first, const Float4 &value,
+	     const Mask4 &active)
+	{ Select(active, value, Get(field, first))
+	  .Store(fields[field] + first); }
+    Vector GetVector(const Field field, const int pod) const
+	{ return Vector(fields[field][pod], fields[field + 1][pod],
+			fields[field + 2][pod]); }
+
+    void LoadFrames(const int first, const Mask4 &lanes);
+    void Control(const int first, const float dt);
+    void Move(const int first, const float dt);
+    void Integrate(const int first, const Float4 &dt, const Float4 &drag,
+		   const Mask4 &active);
+
+    // No copy
+    PodBatch(const PodBatch &);
+    void operator =(const PodBatch &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_PODBATCH_H
+
+// End of File
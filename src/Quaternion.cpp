@@ -0,0 +1,115 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Quaternion.cpp
+ * Description: Rotation Quaternions
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Quaternion.h"
+
+namespace Podz {
+
+Quaternion Quaternion::FromFrame(const Vector &right, const Vector &up,
+				 const Vector &backward)
+{
+    // Frame vectors are the matrix columns; the largest of the trace and the
+    // diagonal terms gives the most accurate square root
+    const float trace = right.x + up.y + backward.z;
+    Quaternion q;
+    if (trace > 0.f) {
+	const float s = sqrtf(trace + 1.f) * 2.f;
+	q.w = s * .25f;
+	q.x = (up.z - backward.y) / s;
+	q.y = (backward.x - right.z) / s;
+	q.z = (right.y - up.x) / s;
+    } else if (right.x > up.y && right.x > backward.z) {
+	const float s = sqrtf(1.f + right.x - up.y - backward.z) * 2.f;
+	q.w = (up.z - backward.y) / s;
+	q.x = s * .25f;
+	q.y = (up.x + right.y) / s;
+	q.z = (backward.x + right.z) / s;
+    } else if (up.y > backward.z) {
+	const float s = sqrtf(1.f + up.y - right.x - backward.z) * 2.f;
+	q.w = (backward.x - right.z) / s;
+	q.x = (up.x + right.y) / s;
+	q.y = s * .25f;
+	q.z = (backward.y + up.z) / s;
+    } else {
+	const float s = sqrtf(1.f + backward.z - right.x - up.y) * 2.f;
+	q.w = (right.y - up.x) / s;
+	q.x = (backward.x + right.z) / s;
+	q.y = (backward.y + up.z) / s;
+	q.z = s * .25f;
+    }
+
+    return q.Normalize();
+}
+
+void Quaternion::ToFrame(Vector &right, Vector &up, Vector &backward) const
+{
+    const float x2 = x + x, y2 = y + y, z2 = z + z;
+    const float xx = x * x2, yy = y * y2, zz = z * z2;
+    const float xy = x * y2, xz = x * z2, yz = y * z2;
+    const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+    right.Set(1.f - (yy + zz), xy + wz, xz - wy);
+    up.Set(xy - wz, 1.f - (xx + zz), yz + wx);
+    backward.Set(xz + wy, yz - wx, 1.f - (xx + yy));
+}
+
+Quaternion &Quaternion::Normalize()
+{
+    const float scale = 1.f / sqrtf(Dot(*this));
+    x *= scale;
+    y *= scale;
+    z *= scale;
+    w *= scale;
+    return *this;
+}
+
+Quaternion Quaternion::Nlerp(const Quaternion &a, const Quaternion &b,
+			     const float coef)
+{
+    // q and -q are the same rotation: take the one closest to a
+    const float ca = 1.f - coef, cb = a.Dot(b) < 0.f ? -coef : coef;
+    return Quaternion(a.x * ca + b.x * cb, a.y * ca + b.y * cb,
+		      a.z * ca + b.z * cb, a.w * ca + b.w * cb).Normalize();
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,70 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Quaternion.h
+ * Description: Rotation Quaternions (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_QUATERNION_H
+#define PODZ_QUATERNION_H
+
+#include "Vector.h"
+
+namespace Podz {
+
+// Unit quaternion, for the orientation of a basis
+class Quaternion
+{
+public:
+    float x, y, z, w;
+
+    // Identity by default
+    Quaternion(float qx = 0.f, float qy = 0.f, float qz = 0.f,
+	       float qw = 1.f)
+	: x(qx), y(qy), z(qz), w(qw) {}
+
+    // Rotation taking the axes to a right-handed orthonormal frame, and back
+    static Quaternion FromFrame(const Vector &right, const Vector &up,
+				const Vector &backward);
+    void ToFrame(Vector &right, Vector &up, Vector &backward) const;
+
+    float Dot(const Quaternion &q) const
+	{ return x * q.x + y * q.y + z * q.z + w * q.w; }
+    Quaternion &Normalize();
+
+    // Normalized linear interpolation, along the shortest arc: not constant
+    // in angular speed like a spherical one, but much cheaper, and as close
+    // as needed between neighbouring frames
+    static Quaternion Nlerp(const Quaternion &a, const Quaternion &b,
+			    const float coef);
+};
+
+} // namespace Podz
+
+#endif // !PODZ_QUATERNION_H
+
+// End of File
@@ -0,0 +1,308 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Race.cpp
+ * Description: Race Between Several Pods
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <algorithm>
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Physics.h"
+#include "Checksum.h"
+#include "Pod.h"
+#include "Pilot.h"
+#include "ThreadPool.h"
+#include "Race.h"
+
+
+namespace Podz {
+
+// Starting grid: the first pod on the line, the others two by two behind
+static const float GRID_ROW = 2.5f;
+static const float GRID_OFFSET = 1.2f;
+
+// Broad phase: pods further apart than that along the track or across it
+// cannot touch (hull diagonals)
+static const float REACH_LENGTH = 2.f * (HULL_HALF_LENGTH + HULL_HALF_WIDTH);
+static const float REACH_WIDTH = REACH_LENGTH;
+
+static inline float Dot(const Vector &a, const Vector &b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+class Race::DecideTask : public ThreadPool::Task
+{
+public:
+    DecideTask(Race &rc) : race(rc) {}
+
+    virtual void Run(const int index)
+    {
+	if (race.pilots[index] != 0)
+	    race.inputs[index] = race.pilots[index]->Decide(*race.pods[index]);
+    }
+
+private:
+    Race &race;
+
+    void operator =(const DecideTask &) const;
+};
+
+// Steps the pods of a class, the index being within that class
+template <class Handling>
+class Race::StepTask : public ThreadPool::Task
+{
+public:
+    StepTask(Race &rc, const std::vector<int> &idx, const float step)
+	: race(rc), indices(idx), dt(step) {}
+
+    virtual void Run(const int index)
+    {
+	const int pod = indices[index];
+	race.pods[pod]->StepClass<Handling>(race.inputs[pod], dt);
+    }
+
+private:
+    Race &race;
+    const std::vector<int> &indices;
+    const float dt;
+
+    void operator =(const StepTask &) const;
+};
+
+Race::Race(const Track &trk, ThreadPool *const thrpool)
+    : track(trk), pool(thrpool), tick(0), checksum(0)
+{}
+
+Race::~Race()
+{
+    for (std::vector<Pilot *>::size_type i = 0; i < pilots.size(); ++i)
+	delete pilots[i];
+}
+
+int Race::AddPod(Pod &pod, Pilot *const pilot)
+{
+    const int index = static_cast<int>(pods.size());
+    if (index > 0) {
+	const int row = (index + 1) / 2;
+	pod.SetStart(-GRID_ROW * static_cast<float>(row),
+		     index % 2 != 0 ? -GRID_OFFSET : GRID_OFFSET);
+	pod.Init();
+    }
+
+    pods.push_back(&pod);
+    classes[pod.GetClass()].push_back(index);
+    pilots.push_back(pilot);
+    inputs.push_back(0);
+    checksums.push_back(0);
+    UpdateChecksum();
+
+    return index;
+}
+
+void Race::SetPilot(const int index, Pilot *const pilot)
+{
+    delete pilots[index];
+    pilots[index] = pilot;
+    inputs[index] = 0;
+}
+
+void Race::Init()
+{
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i) {
+	pods[i]->Init();
+	inputs[i] = 0;
+    }
+    tick = 0;
+    UpdateChecksum();
+}
+
+void Race::Save(Pod::State *const states) const
+{
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	pods[i]->Save(states[i]);
+}
+
+void Race::Restore(const Pod::State *const states, const int tck)
+{
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	pods[i]->Restore(states[i]);
+    tick = tck;
+    UpdateChecksum();
+}
+
+void Race::Step(const float dt)
+{
+    const int count = GetPodCount();
+
+    // All the decisions are taken on the same state, before any move
+    DecideTask decide(*this);
+    if (pool != 0)
+	pool->Run(decide, count);
+    else {
+	for (int i = 0; i < count; ++i)
+	    decide.Run(i);
+    }
+
+    // The moves are independent: the class order does not matter
+    StepClass<StandardHandling>(Pod::CLASS_STANDARD, dt);
+    StepClass<LightHandling>(Pod::CLASS_LIGHT, dt);
+    StepClass<HeavyHandling>(Pod::CLASS_HEAVY, dt);
+
+    Collide();
+    ++tick;
+    UpdateChecksum();
+}
+
+template <class Handling>
+void Race::StepClass(const Pod::Class cls, const float dt)
+{
+    const int count = static_cast<int>(classes[cls].size());
+    if (count == 0)
+	return;
+
+    StepTask<Handling> step(*this, classes[cls], dt);
+    if (pool != 0)
+	pool->Run(step, count);
+    else {
+	for (int i = 0; i < count; ++i)
+	    step.Run(i);
+    }
+}
+
+void Race::UpdateChecksum()
+{
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	checksums[i] = pods[i]->GetChecksum();
+    checksum = Checksum::Compute(&checksums[0],
+				 checksums.size() * sizeof(unsigned),
+				 static_cast<unsigned>(tick));
+}
+
+void Race::Collide()
+{
+    const int count = GetPodCount();
+    const float total = track.GetTotalLength();
+
+    // Sort by position within the lap, so that only pods in the same or the
+    // next arc-length bucket (REACH_LENGTH long) are tested
+    entries.resize(count);
+    for (int i = 0; i < count; ++i) {
+	const Pod &pod = *pods[i];
+	Entry &entry = entries[i];
+	entry.position = fmodf(pod.GetCircPosition(), total);
+	if (entry.position < 0.f)
+	    entry.position += total;
+	entry.offset = pod.GetBasis().RevertPoint(pod.GetPosition()).x;
+	entry.index = i;
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (int i = 0; i < count; ++i) {
+	const Entry &first = entries[i];
+	for (int j = i + 1; j < i + count; ++j) {
+	    // Wrap around the start line
+	    const Entry &second = entries[j % count];
+	    const float gap = second.position - first.position
+			    + (j >= count ? total : 0.f);
+	    if (gap > REACH_LENGTH)
+		break;
+	    if (fabsf(second.offset - first.offset) <= REACH_WIDTH)
+		Collide(*pods[first.index], *pods[second.index]);
+	}
+    }
+}
+
+void Race::Collide(Pod &first, Pod &second)
+{
+    // Narrow phase: both hulls as rectangles in the track plane of the first
+    // pod, tested with the separating axis theorem
+    const Basis &basis = first.GetBasis();
+    Vector relative = basis.RevertVector(second.GetPosition()
+					 - first.GetPosition());
+    if (fabsf(relative.y) > 2.f * HULL_HALF_HEIGHT)
+	return;
+    relative.y = 0.f;
+
+    Vector ahead[2] = { basis.RevertVector(first.GetDirection()),
+			basis.RevertVector(second.GetDirection()) };
+    Vector side[2];
+    for (int i = 0; i < 2; ++i) {
+	ahead[i].y = 0.f;
+	ahead[i] %= 1.f;
+	side[i].Set(-ahead[i].z, 0.f, ahead[i].x);
+    }
+    const Vector center = relative + (ahead[1] - ahead[0]) * HULL_FORWARD;
+
+    const Vector *const axes[4] = { &ahead[0], &side[0], &ahead[1], &side[1] };
+    float depth = 0.f;
+    Vector normal;
+    for (int i = 0; i < 4; ++i) {
+	const Vector &axis = *axes[i];
+	const float distance = Dot(center, axis);
+	float overlap = -fabsf(distance);
+	for (int j = 0; j < 2; ++j)
+	    overlap += HULL_HALF_LENGTH * fabsf(Dot(ahead[j], axis))
+		     + HULL_HALF_WIDTH * fabsf(Dot(side[j], axis));
+	if (overlap <= 0.f)
+	    return;
+	if (i == 0 || overlap < depth) {
+	    depth = overlap;
+	    normal = distance < 0.f ? -axis : axis;
+	}
+    }
+
+    // Push the pods apart, and bounce if they are closing in; each one takes
+    // the share of the other one's mass
+    normal = basis.TransformVector(normal);
+    const float total = first.GetMass() + second.GetMass();
+    const float share[2] = { second.GetMass() / total,
+			     first.GetMass() / total };
+    const float closing = Dot(second.GetSpeed() - first.GetSpeed(), normal);
+    const float bounce = -(1.f + HULL_RESTITUTION) * closing;
+    first.Bump(normal * -(depth * share[0]), closing < 0.f
+	       ? normal * -(bounce * share[0]) : Vector());
+    second.Bump(normal * (depth * share[1]), closing < 0.f
+		? normal * (bounce * share[1]) : Vector());
+}
+
+} // namespace Podz
+
+// End of File
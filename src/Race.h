@@ -0,0 +1,125 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Race.h
+ * Description: Race Between Several Pods (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_RACE_H
+#define PODZ_RACE_H
+
+#include <vector>
+
+#include "Pod.h"
+
+namespace Podz
+{
+
+class Track;
+class Pilot;
+class ThreadPool;
+
+// Pods racing on the same track: the player ones get their inputs from
+// outside, the others from their pilots; every tick, all the pilots decide
+// in parallel, then all the pods move in parallel, class by class, then
+// colliding pods bounce off each other
+class Race
+{
+public:
+    Race(const Track &trk, ThreadPool *const thrpool = 0);
+    ~Race();
+
+    // The race takes ownership of the pilot, not of the pod; without any
+    // pilot, the pod input is set by SetInput().  Pods are lined up on a
+    // starting grid, in the order they are added.
+    int AddPod(Pod &pod, Pilot *const pilot = 0);
+
+    // Hands a pod over to another pilot, or to SetInput() without any; the
+    // previous pilot is deleted
+    void SetPilot(const int index, Pilot *const pilot);
+
+    int GetPodCount() const { return static_cast<int>(pods.size()); }
+    Pod &GetPod(const int index) const { return *pods[index]; }
+    unsigned GetInput(const int index) const { return inputs[index]; }
+    void SetInput(const int index, const unsigned input)
+	{ inputs[index] = input; }
+
+    // Simulation, dt being the time step in seconds
+    void Init();
+    void Step(const float dt);
+    int GetTick() const { return tick; }
+
+    // Hash of the state of all pods after the last step (or Init()), one
+    // per tick: two runs diverge at the first tick their checksums differ
+    unsigned GetChecksum() const { return checksum; }
+
+    // State of all pods, GetPodCount() entries
+    void Save(Pod::State *const states) const;
+    void Restore(const Pod::State *const states, const int tck);
+
+private:
+    const Track &track;
+    ThreadPool *pool;
+
+    std::vector<Pod *> pods;
+    std::vector<int> classes[Pod::CLASS_NUM]; // Pod indices, by class
+    std::vector<Pilot *> pilots;
+    std::vector<unsigned> inputs;
+    int tick;
+    unsigned checksum;
+    std::vector<unsigned> checksums;
+
+    // Broad phase: pods sorted by position along the track
+    struct Entry {
+	float position, offset;
+	int index;
+
+	bool operator <(const Entry &e) const
+	    { return position < e.position ||
+		     (position == e.position && index < e.index); }
+    };
+    std::vector<Entry> entries;
+
+    class DecideTask;
+    template <class Handling> class StepTask;
+
+    template <class Handling> void StepClass(const Pod::Class cls,
+					     const float dt);
+    void Collide();
+    void Collide(Pod &first, Pod &second);
+    void UpdateChecksum();
+
+    // No copy
+    Race(const Race &);
+    void operator =(const Race &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_RACE_H
+
+// End of File
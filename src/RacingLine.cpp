@@ -0,0 +1,160 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/RacingLine.cpp
+ * Description: Racing Line
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <algorithm>
+#include <fstream>
+
+// System
+#include <cmath>
+
+// This module
+#include "Track.h"
+#include "RacingLine.h"
+
+
+namespace Podz {
+
+// File layout: magic, version, node count as a variable-length integer (7
+// bits per byte, low bits first), then one signed byte per node, in 1/127
+// of the half track width
+static const char MAGIC[4] = { 'P', 'o', 'd', 'L' };
+static const unsigned char VERSION = 1;
+static const float NODE_SCALE = 127.f;
+static const float NODE_SPACING = 2.f;
+
+static int CountNodes(const Track &track)
+{
+    const int count = static_cast<int>(track.GetTotalLength() / NODE_SPACING
+				       + .5f);
+    return count > 1 ? count : 1;
+}
+
+RacingLine::RacingLine(const Track &trk)
+    : spacing(trk.GetTotalLength() / static_cast<float>(CountNodes(trk))),
+      nodes(CountNodes(trk), 0.f)
+{}
+
+void RacingLine::SetNode(const int index, const float offset)
+{
+    const float clamped = offset < -1.f ? -1.f : offset > 1.f ? 1.f : offset;
+    nodes[index] = floorf(clamped * NODE_SCALE + .5f) / NODE_SCALE;
+}
+
+float RacingLine::GetOffset(const float position) const
+{
+    const int count = GetCount();
+    const float node = position / spacing;
+    const float base = floorf(node);
+    int index = static_cast<int>(base) % count;
+    if (index < 0)
+	index += count;
+
+    const float next = nodes[index + 1 < count ? index + 1 : 0];
+    return nodes[index] + (next - nodes[index]) * (node - base);
+}
+
+bool RacingLine::Save(const char *const filename) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    if (!file.is_open())
+	return false;
+
+    file.write(MAGIC, sizeof(MAGIC));
+    file.put(static_cast<char>(VERSION));
+    for (unsigned count = nodes.size(); ; count >>= 7) {
+	if (count < 0x80) {
+	    file.put(static_cast<char>(count));
+	    break;
+	}
+	file.put(static_cast<char>((count & 0x7f) | 0x80));
+    }
+    for (std::vector<float>::size_type i = 0; i < nodes.size(); ++i)
+	file.put(static_cast<char>(static_cast<signed char>(
+		floorf(nodes[i] * NODE_SCALE + .5f))));
+
+    file.flush();
+    return file.good();
+}
+
+bool RacingLine::Load(const char *const filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file.good() || !std::equal(magic, magic + sizeof(magic), MAGIC) ||
+	file.get() != VERSION)
+	return false;
+
+    unsigned count = 0;
+    for (int shift = 0; ; shift += 7) {
+	const int byte = file.get();
+	if (byte == std::ifstream::traits_type::eof() || shift >= 32)
+	    return false;
+	count |= static_cast<unsigned>(byte & 0x7f) << shift;
+	if ((byte & 0x80) == 0)
+	    break;
+    }
+    if (count != nodes.size())
+	return false;
+
+    std::vector<float> loaded(count);
+    for (unsigned i = 0; i < count; ++i) {
+	const int byte = file.get();
+	if (byte == std::ifstream::traits_type::eof())
+	    return false;
+	loaded[i] = static_cast<float>(static_cast<signed char>(byte))
+		  / NODE_SCALE;
+    }
+
+    nodes.swap(loaded);
+    return true;
+}
+
+std::string RacingLine::GetFileName(const char *const level)
+{
+    std::string name(level);
+    const std::string::size_type dot = name.rfind('.');
+    const std::string::size_type slash = name.find_last_of("/\\");
+    if (dot != std::string::npos &&
+	(slash == std::string::npos || dot > slash))
+	name.erase(dot);
+    return name + ".line";
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,82 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/RacingLine.h
+ * Description: Racing Line (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_RACINGLINE_H
+#define PODZ_RACINGLINE_H
+
+#include <vector>
+#include <string>
+
+namespace Podz
+{
+
+class Track;
+
+// Lateral offset to drive at along a track, as a fraction of the half
+// track width (-1 for the left border, 1 for the right one), with nodes
+// about two units apart, evenly spread along the track: they do not depend
+// on how the track is tessellated, only on its length.  Lines are computed
+// offline (see podz-line) and stored next to their level, one byte per
+// node.
+class RacingLine
+{
+public:
+    // The centre line
+    RacingLine(const Track &trk);
+
+    int GetCount() const { return static_cast<int>(nodes.size()); }
+    float GetNode(const int index) const { return nodes[index]; }
+
+    // Offsets are rounded as when saved, so that a line drives the same
+    // once loaded again
+    void SetNode(const int index, const float offset);
+
+    // Offset at a track position, interpolated between nodes
+    float GetOffset(const float position) const;
+
+    // Loading fails on lines with another node count than the track length
+    // gives
+    bool Save(const char *const filename) const;
+    bool Load(const char *const filename);
+
+    // File of the racing line of a level: "level.txt" gives "level.line"
+    static std::string GetFileName(const char *const level);
+
+private:
+    float spacing;
+    std::vector<float> nodes;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_RACINGLINE_H
+
+// End of File
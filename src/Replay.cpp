@@ -0,0 +1,292 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Replay.cpp
+ * Description: Input Recording and Playback
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <algorithm>
+#include <fstream>
+
+// System
+#include <climits>
+
+// This module
+#include "Pod.h"
+#include "RacingLine.h"
+#include "Replay.h"
+
+
+namespace Podz {
+
+// File layout: magic, version, then variable-length integers (7 bits per
+// byte, low bits first): rate, level hash, opponents, run count and runs,
+// each run being its length shifted left by INPUT_BITS, ored with the input
+static const char MAGIC[4] = { 'P', 'o', 'd', 'z' };
+static const unsigned char VERSION = 4;
+static const int INPUT_BITS = 4;
+
+static const char *const errors[Replay::ERROR_NUM] = {
+    "no error",
+    "cannot open file",
+    "not a replay",
+    "replay of another version",
+    "truncated replay",
+    "malformed number",
+    "tick rate out of bounds",
+    "too many opponents",
+    "empty or too long run"
+};
+
+static void WriteNumber(std::ostream &file, unsigned value)
+{
+    while (value >= 0x80) {
+	file.put(static_cast<char>((value & 0x7f) | 0x80));
+	value >>= 7;
+    }
+    file.put(static_cast<char>(value));
+}
+
+static bool ReadNumber(std::istream &file, unsigned &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+	const int byte = file.get();
+	if (byte == std::istream::traits_type::eof())
+	    return false;
+	value |= static_cast<unsigned>(byte & 0x7f) << shift;
+	if ((byte & 0x80) == 0)
+	    return true;
+    }
+    return false;
+}
+
+Replay::Replay()
+    : ticks(0), rate(0), levelHash(0), opponents(0), error(ERROR_NONE),
+      run(0), played(0)
+{}
+
+void Replay::Start(const int tickRate, const unsigned level, const int opp)
+{
+    rate = tickRate;
+    levelHash = level;
+    opponents = opp;
+    Clear();
+}
+
+void Replay::Record(const unsigned input)
+{
+    const unsigned masked = input & Pod::INPUT_MASK;
+    if (runs.empty() || runs.back().input != masked) {
+	const Run entry = { masked, 0 };
+	runs.push_back(entry);
+    }
+    ++runs.back().ticks;
+    ++ticks;
+}
+
+void Replay::Clear()
+{
+    runs.clear();
+    ticks = 0;
+    Rewind();
+}
+
+void Replay::Truncate(const int tickCount)
+{
+    while (ticks > tickCount) {
+	Run &last = runs.back();
+	const int excess = ticks - tickCount;
+	if (last.ticks > excess) {
+	    last.ticks -= excess;
+	    ticks = tickCount;
+	} else {
+	    ticks -= last.ticks;
+	    runs.pop_back();
+	}
+    }
+    Rewind();
+}
+
+void Replay::Rewind()
+{
+    run = 0;
+    played = 0;
+}
+
+bool Replay::Play(unsigned &input)
+{
+    if (run == runs.size())
+	return false;
+
+    input = runs[run].input;
+    if (++played == runs[run].ticks) {
+	++run;
+	played = 0;
+    }
+    return true;
+}
+
+void Replay::Seek(const int tick)
+{
+    Rewind();
+    for (int remaining = tick; remaining > 0 && run < runs.size(); ) {
+	if (runs[run].ticks <= remaining)
+	    remaining -= runs[run++].ticks;
+	else {
+	    played = remaining;
+	    remaining = 0;
+	}
+    }
+}
+
+bool Replay::Save(const char *const filename) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    return file.is_open() && Save(file);
+}
+
+bool Replay::Load(const char *const filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+	error = ERROR_OPEN;
+	return false;
+    }
+    return Load(file);
+}
+
+bool Replay::Save(std::ostream &file) const
+{
+    file.write(MAGIC, sizeof(MAGIC));
+    file.put(static_cast<char>(VERSION));
+    WriteNumber(file, static_cast<unsigned>(rate));
+    WriteNumber(file, levelHash);
+    WriteNumber(file, static_cast<unsigned>(opponents));
+    WriteNumber(file, static_cast<unsigned>(runs.size()));
+    for (std::vector<Run>::size_type i = 0; i < runs.size(); ++i)
+	WriteNumber(file, static_cast<unsigned>(runs[i].ticks) << INPUT_BITS
+			  | runs[i].input);
+
+    file.flush();
+    return file.good();
+}
+
+bool Replay::Load(std::istream &file)
+{
+    error = Read(file);
+    return error == ERROR_NONE;
+}
+
+const char *Replay::GetErrorString(const Error err)
+{
+    return errors[err];
+}
+
+Replay::Error Replay::Read(std::istream &file)
+{
+    char magic[sizeof(MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file.good() || !std::equal(magic, magic + sizeof(magic), MAGIC))
+	return ERROR_MAGIC;
+    if (file.get() != VERSION)
+	return file.eof() ? ERROR_TRUNCATED : ERROR_VERSION;
+
+    unsigned tickRate, level, opp, count;
+    if (!ReadNumber(file, tickRate) || !ReadNumber(file, level) ||
+	!ReadNumber(file, opp) || !ReadNumber(file, count))
+	return file.eof() ? ERROR_TRUNCATED : ERROR_NUMBER;
+
+    if (tickRate < MIN_RATE || tickRate > MAX_RATE)
+	return ERROR_RATE;
+    if (opp > MAX_OPPONENTS)
+	return ERROR_OPPONENTS;
+
+    // The run count is not trusted to reserve memory: runs are read until
+    // it is reached or the file ends
+    Start(static_cast<int>(tickRate), level, static_cast<int>(opp));
+    for (unsigned i = 0; i < count; ++i) {
+	unsigned value;
+	if (!ReadNumber(file, value))
+	    return file.eof() ? ERROR_TRUNCATED : ERROR_NUMBER;
+	if (value >> INPUT_BITS == 0 ||
+	    static_cast<int>(value >> INPUT_BITS) > INT_MAX - ticks)
+	    return ERROR_RUN;
+
+	const Run entry = { value & Pod::INPUT_MASK,
+			    static_cast<int>(value >> INPUT_BITS) };
+	runs.push_back(entry);
+	ticks += entry.ticks;
+    }
+
+    return ERROR_NONE;
+}
+
+// FNV-1a, going on from the given hash
+static bool HashStream(std::istream &file, unsigned &hash)
+{
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)), file.gcount() > 0) {
+	const std::streamsize size = file.gcount();
+	for (std::streamsize i = 0; i < size; ++i) {
+	    hash ^= static_cast<unsigned char>(buffer[i]);
+	    hash *= 16777619u;
+	}
+    }
+
+    return !file.bad();
+}
+
+bool Replay::HashFile(const char *const filename, unsigned &hash)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+	return false;
+
+    hash = 2166136261u;
+    return HashStream(file, hash);
+}
+
+bool Replay::HashLevel(const char *const level, unsigned &hash)
+{
+    if (!HashFile(level, hash))
+	return false;
+
+    std::ifstream line(RacingLine::GetFileName(level).c_str(),
+		       std::ios::in | std::ios::binary);
+    return !line.is_open() || HashStream(line, hash);
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,125 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Replay.h
+ * Description: Input Recording and Playback (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_REPLAY_H
+#define PODZ_REPLAY_H
+
+#include <vector>
+#include <iosfwd>
+
+namespace Podz
+{
+
+// Inputs of the player pod, one bit mask (Pod::Input) per tick, along with
+// what is needed to simulate them again the same way: level file hash,
+// tick rate and number of opponents.  Inputs are stored as runs of
+// identical ticks, written to files as variable-length integers.
+class Replay
+{
+public:
+    // What the game records: tick rate bounds, in ticks per second, and
+    // maximum number of opponents
+    enum { MIN_RATE = 10, MAX_RATE = 1000, MAX_OPPONENTS = 63 };
+
+    // Why the last loading failed
+    enum Error {
+	ERROR_NONE,
+	ERROR_OPEN,      // File cannot be opened
+	ERROR_MAGIC,     // Not a replay
+	ERROR_VERSION,   // Replay of another version
+	ERROR_TRUNCATED, // File ends too early
+	ERROR_NUMBER,    // Number longer than 32 bits
+	ERROR_RATE,      // Tick rate out of MIN_RATE..MAX_RATE
+	ERROR_OPPONENTS, // More than MAX_OPPONENTS
+	ERROR_RUN,       // Empty run, or more than INT_MAX ticks in all
+	ERROR_NUM
+    };
+
+    Replay();
+
+    // Recording, from the first tick of a race
+    void Start(const int tickRate, const unsigned level, const int opp);
+    void Record(const unsigned input);
+    void Clear();
+    void Truncate(const int tickCount);
+
+    // Playback: the input of the next tick, false when there is none left
+    void Rewind();
+    bool Play(unsigned &input);
+    void Seek(const int tick);
+
+    // Loading fails on rates and opponent counts out of the bounds above,
+    // GetError() telling why
+    bool Save(const char *const filename) const;
+    bool Load(const char *const filename);
+    bool Save(std::ostream &file) const;
+    bool Load(std::istream &file);
+    Error GetError() const { return error; }
+    static const char *GetErrorString(const Error err);
+
+    int GetRate() const { return rate; }
+    unsigned GetLevelHash() const { return levelHash; }
+    int GetOpponents() const { return opponents; }
+    int GetTickCount() const { return ticks; }
+    int GetRunCount() const { return static_cast<int>(runs.size()); }
+
+    // FNV-1a hash of a whole file, false if it cannot be read
+    static bool HashFile(const char *const filename, unsigned &hash);
+
+    // Same for a level file followed by its racing line, if any: the line
+    // drives the opponents, so it is part of the level
+    static bool HashLevel(const char *const level, unsigned &hash);
+
+private:
+    struct Run {
+	unsigned input;
+	int ticks;
+    };
+
+    std::vector<Run> runs;
+    int ticks;
+    int rate;
+    unsigned levelHash;
+    int opponents;
+    Error error;
+
+    // Playback position
+    std::vector<Run>::size_type run;
+    int played;
+
+    Error Read(std::istream &file);
+};
+
+} // namespace Podz
+
+#endif // !PODZ_REPLAY_H
+
+// End of File
@@ -0,0 +1,266 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Server.cpp
+ * Description: Multiplayer Server
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <algorithm>
+
+// System
+#include <cmath>
+
+// This module
+#include "Track.h"
+#include "Pod.h"
+#include "Pilot.h"
+#include "Race.h"
+#include "ThreadPool.h"
+#include "Socket.h"
+#include "Packet.h"
+#include "Snapshot.h"
+#include "Server.h"
+
+
+namespace Podz {
+
+Server::Server(const Track &trk, const unsigned level, const int tickRate,
+	       const int nb_pods, ThreadPool *const pool,
+	       const RacingLine *const racing)
+    : track(trk), racingLine(racing), levelHash(level), rate(tickRate), race(trk, pool),
+      owners(nb_pods, static_cast<Peer *>(0)), order(nb_pods),
+      ranks(nb_pods), keys(nb_pods), bytesSent(0), snapshotsSent(0)
+{
+    for (int i = 0; i < nb_pods; ++i) {
+	pods.push_back(new Pod(trk));
+	race.AddPod(*pods[i], Pilot::CreateOpponent(trk, i, racing));
+	order[i] = i;
+    }
+}
+
+Server::~Server()
+{
+    for (Peers::iterator i = peers.begin(); i != peers.end(); ++i)
+	delete i->second;
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	delete pods[i];
+}
+
+bool Server::Open(const unsigned short port)
+{
+    return socket.Open(port);
+}
+
+void Server::Tick()
+{
+    Receive();
+
+    // Silent clients leave their pod to a pilot again
+    const int timeout = TIMEOUT * rate;
+    for (Peers::iterator i = peers.begin(); i != peers.end();) {
+	const Peers::iterator peer = i++;
+	if (race.GetTick() - peer->second->heard > timeout)
+	    Disconnect(peer);
+	else
+	    race.SetInput(peer->second->pod, peer->second->input);
+    }
+
+    race.Step(1.f / static_cast<float>(rate));
+
+    // Pods are quantized once, whatever the number of clients seeing them
+    const int count = race.GetPodCount();
+    current.Clear(race.GetTick());
+    for (int i = 0; i < count; ++i)
+	current.Add(i, *pods[i]);
+    Sort();
+
+    for (Peers::iterator i = peers.begin(); i != peers.end(); ++i)
+	Send(*i->second);
+}
+
+void Server::Receive()
+{
+    Socket::Address from;
+    int length;
+    while ((length = socket.Receive(from, packet.GetData(),
+				    Packet::MAX_SIZE)) > 0) {
+	const unsigned type = packet.Open(length);
+	if (type == Packet::HELLO) {
+	    const unsigned level = packet.ReadNumber();
+	    const unsigned tickRate = packet.ReadNumber();
+	    if (packet.HasError())
+		continue;
+	    if (level == levelHash && tickRate == static_cast<unsigned>(rate))
+		Welcome(from);
+	    else
+		Refuse(from);
+	} else if (type == Packet::INPUT) {
+	    const Peers::iterator peer = peers.find(from);
+	    const unsigned sequence = packet.ReadNumber();
+	    const int ack = static_cast<int>(packet.ReadNumber()) - 1;
+	    const unsigned input = packet.ReadByte();
+	    if (packet.HasError())
+		continue;
+	    if (peer == peers.end()) {
+		// Disconnected for being silent too long: it has to join again
+		Refuse(from);
+		continue;
+	    }
+
+	    // Datagrams may arrive out of order: only keep the latest input
+	    Peer &client = *peer->second;
+	    client.heard = race.GetTick();
+	    if (sequence > client.sequence) {
+		client.sequence = sequence;
+		client.input = input & Pod::INPUT_MASK;
+		if (ack > client.ack && ack <= race.GetTick())
+		    client.ack = ack;
+	    }
+	}
+    }
+}
+
+void Server::Welcome(const Socket::Address &from)
+{
+    // The client says hello again when the welcome got lost
+    const Peers::iterator peer = peers.find(from);
+    int pod = -1;
+    if (peer != peers.end())
+	pod = peer->second->pod;
+    else {
+	for (int i = 0; i < race.GetPodCount() && pod < 0; ++i)
+	    if (owners[i] == 0)
+		pod = i;
+	if (pod < 0) {
+	    Refuse(from);
+	    return;
+	}
+
+	Peer *const client = new Peer;
+	client->address = from;
+	client->pod = pod;
+	client->sequence = 0;
+	client->input = 0;
+	client->ack = -1;
+	client->heard = race.GetTick();
+	peers[from] = client;
+	owners[pod] = client;
+	race.SetPilot(pod, 0);
+    }
+
+    packet.Start(Packet::WELCOME);
+    packet.WriteNumber(static_cast<unsigned>(pod));
+    socket.Send(from, packet.GetData(), packet.GetSize());
+}
+
+void Server::Refuse(const Socket::Address &to)
+{
+    packet.Start(Packet::REFUSED);
+    socket.Send(to, packet.GetData(), packet.GetSize());
+}
+
+void Server::Disconnect(const Peers::iterator peer)
+{
+    const int pod = peer->second->pod;
+    race.SetPilot(pod, Pilot::CreateOpponent(track, pod, racingLine));
+    owners[pod] = 0;
+    delete peer->second;
+    peers.erase(peer);
+}
+
+void Server::Sort()
+{
+    const int count = race.GetPodCount();
+    const float total = track.GetTotalLength();
+    for (int i = 0; i < count; ++i) {
+	float key = fmodf(pods[i]->GetCircPosition(), total);
+	if (key < 0.f)
+	    key += total;
+	keys[i] = key;
+    }
+
+    // Insertion sort: the order barely changes from a tick to the next
+    for (int r = 1; r < count; ++r) {
+	const int pod = order[r];
+	int s = r;
+	while (s > 0 && (keys[pod] < keys[order[s - 1]] ||
+			 (keys[pod] == keys[order[s - 1]] &&
+			  pod < order[s - 1]))) {
+	    order[s] = order[s - 1];
+	    --s;
+	}
+	order[s] = pod;
+    }
+    for (int r = 0; r < count; ++r)
+	ranks[order[r]] = r;
+}
+
+void Server::Send(Peer &client)
+{
+    const int tick = race.GetTick();
+    const int count = race.GetPodCount();
+
+    // The client pod first, then alternately the next ones ahead and behind
+    Snapshot &snapshot = client.sent[tick % Snapshot::HISTORY];
+    snapshot.Clear(tick);
+    const int visible = std::min(static_cast<int>(MAX_VISIBLE), count);
+    const int rank = ranks[client.pod];
+    snapshot.Add(current.GetSample(client.pod));
+    for (int k = 1; snapshot.GetCount() < visible; ++k) {
+	snapshot.Add(current.GetSample(order[(rank + k) % count]));
+	if (snapshot.GetCount() < visible)
+	    snapshot.Add(current.GetSample(order[(rank - k + count) % count]));
+    }
+
+    // Differences with the latest snapshot the client has, if still known
+    const Snapshot *base = 0;
+    if (client.ack >= 0 && tick - client.ack < Snapshot::HISTORY &&
+	client.sent[client.ack % Snapshot::HISTORY].GetTick() == client.ack)
+	base = &client.sent[client.ack % Snapshot::HISTORY];
+
+    packet.Start(Packet::SNAPSHOT);
+    packet.WriteNumber(static_cast<unsigned>(tick));
+    packet.WriteNumber(base != 0 ? static_cast<unsigned>(tick - client.ack)
+				 : 0u);
+    packet.WriteNumber(static_cast<unsigned>(client.pod));
+    snapshot.Write(packet, base);
+    if (!packet.HasError() &&
+	socket.Send(client.address, packet.GetData(), packet.GetSize())) {
+	bytesSent += static_cast<unsigned long>(packet.GetSize());
+	++snapshotsSent;
+    }
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,129 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Server.h
+ * Description: Multiplayer Server (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_SERVER_H
+#define PODZ_SERVER_H
+
+#include <vector>
+#include <map>
+
+#include "Socket.h"
+#include "Packet.h"
+#include "Snapshot.h"
+#include "Race.h"
+
+namespace Podz
+{
+
+class Track;
+class Pod;
+class ThreadPool;
+class RacingLine;
+
+// Authoritative race shared over UDP: clients send their inputs every
+// tick, and get back a snapshot of the pods around them, as differences
+// with the last snapshot they acknowledged.  Every pod is driven by a
+// pilot until a client takes it over, and again once the client is gone.
+// Clients only see the pods nearest to them along the track, so that the
+// bandwidth and server time spent on each client do not depend on how
+// many pods race.
+class Server
+{
+public:
+    // Pods seen by each client, including its own
+    enum { MAX_VISIBLE = 8 };
+
+    // Clients silent for that long are disconnected, in seconds
+    enum { TIMEOUT = 5 };
+
+    Server(const Track &trk, const unsigned level, const int tickRate,
+	   const int nb_pods, ThreadPool *const pool = 0,
+	   const RacingLine *const racing = 0);
+    ~Server();
+
+    bool Open(const unsigned short port = Socket::DEFAULT_PORT);
+
+    // Reads the pending inputs, steps the race and sends the snapshots
+    void Tick();
+
+    const Race &GetRace() const { return race; }
+    int GetClientCount() const { return static_cast<int>(peers.size()); }
+
+    // Totals since the server was created
+    unsigned long GetBytesSent() const { return bytesSent; }
+    unsigned long GetSnapshotsSent() const { return snapshotsSent; }
+
+private:
+    struct Peer {
+	Socket::Address address;
+	int pod;
+	unsigned sequence, input;
+	int ack;   // Tick of the latest snapshot received, -1 for none
+	int heard; // Tick of the latest packet
+	Snapshot sent[Snapshot::HISTORY];
+    };
+    typedef std::map<Socket::Address, Peer *> Peers;
+
+    const Track &track;
+    const RacingLine *racingLine;
+    const unsigned levelHash;
+    const int rate;
+    Socket socket;
+    Race race;
+    std::vector<Pod *> pods;
+    std::vector<Peer *> owners; // Client of each pod, if any
+    Peers peers;
+
+    // Every pod once per tick, and pods sorted along the track
+    Snapshot current;
+    std::vector<int> order, ranks;
+    std::vector<float> keys;
+
+    Packet packet;
+    unsigned long bytesSent, snapshotsSent;
+
+    void Receive();
+    void Welcome(const Socket::Address &from);
+    void Refuse(const Socket::Address &to);
+    void Disconnect(const Peers::iterator peer);
+    void Sort();
+    void Send(Peer &client);
+
+    // No copy
+    Server(const Server &);
+    void operator =(const Server &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_SERVER_H
+
+// End of File
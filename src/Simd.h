@@ -0,0 +1,216 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Simd.h
+ * Description: Portable 4-Wide SIMD Types
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_SIMD_H
+#define PODZ_SIMD_H
+
+// SSE2 is used when available (always on x86-64); otherwise, or when
+// PODZ_NO_SIMD is defined, the same types are implemented with scalars
+#if defined(__SSE2__) && !defined(PODZ_NO_SIMD)
+# define PODZ_SIMD_SSE 1
+# include <emmintrin.h>
+#else // !__SSE2__ || PODZ_NO_SIMD
+# include <cmath>
+#endif // !__SSE2__ || PODZ_NO_SIMD
+
+
+namespace Podz {
+
+// Four lane comparison results
+class Mask4
+{
+public:
+#ifdef PODZ_SIMD_SSE
+    __m128 m;
+
+    Mask4(const __m128 vm) : m(vm) {}
+    Mask4(const bool m0, const bool m1, const bool m2, const bool m3)
+	: m(_mm_castsi128_ps(_mm_set_epi32(-static_cast<int>(m3),
+					   -static_cast<int>(m2),
+					   -static_cast<int>(m1),
+					   -static_cast<int>(m0)))) {}
+
+    Mask4 operator &(const Mask4 &o) const { return _mm_and_ps(m, o.m); }
+    Mask4 operator |(const Mask4 &o) const { return _mm_or_ps(m, o.m); }
+    Mask4 operator ~() const
+	{ return _mm_xor_ps(m, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+
+    // One bit per lane, lane 0 being the least significant one
+    int Bits() const { return _mm_movemask_ps(m); }
+#else // !PODZ_SIMD_SSE
+    bool m[4];
+
+    Mask4(const bool m0, const bool m1, const bool m2, const bool m3)
+	{ m[0] = m0, m[1] = m1, m[2] = m2, m[3] = m3; }
+
+    Mask4 operator &(const Mask4 &o) const
+	{ return Mask4(m[0] && o.m[0], m[1] && o.m[1],
+		       m[2] && o.m[2], m[3] && o.m[3]); }
+    Mask4 operator |(const Mask4 &o) const
+	{ return Mask4(m[0] || o.m[0], m[1] || o.m[1],
+		       m[2] || o.m[2], m[3] || o.m[3]); }
+    Mask4 operator ~() const { return Mask4(!m[0], !m[1], !m[2], !m[3]); }
+
+    int Bits() const { return m[0] | m[1] << 1 | m[2] << 2 | m[3] << 3; }
+#endif // !PODZ_SIMD_SSE
+
+    bool Any() const { return Bits() != 0; }
+    bool Get(const int lane) const { return (Bits() >> lane & 1) != 0; }
+
+    // Lanes of an integer array having all the given bits set
+    static Mask4 Test(const unsigned values[4], const unsigned bits)
+	{ return Mask4((values[0] & bits) == bits, (values[1] & bits) == bits,
+		       (values[2] & bits) == bits, (values[3] & bits) == bits); }
+};
+
+// Four floats, processed in parallel
+class Float4
+{
+public:
+#ifdef PODZ_SIMD_SSE
+    __m128 v;
+
+    Float4() {}
+    Float4(const __m128 vv) : v(vv) {}
+    Float4(const float f) : v(_mm_set1_ps(f)) {}
+    Float4(const float f0, const float f1, const float f2, const float f3)
+        : v(_mm_setr_ps(f0, f1, f2, f3)) {}
+
+    float Get(const int lane) const
+        { float lanes[4]; _mm_storeu_ps(lanes, v); return lanes[lane]; }
+
+    // Pointers must be 16-byte aligned, except for the unaligned variants
+    static Float4 Load(const float *const p) { return _mm_load_ps(p); }
+    void Store(float *const p) const { _mm_store_ps(p, v); }
+    static Float4 LoadUnaligned(const float *const p)
+	{ return _mm_loadu_ps(p); }
+    void StoreUnaligned(float *const p) const { _mm_storeu_ps(p, v); }
+
+    Float4 operator +(const Float4 &o) const { return _mm_add_ps(v, o.v); }
+    Float4 operator -(const Float4 &o) const { return _mm_sub_ps(v, o.v); }
+    Float4 operator *(const Float4 &o) const { return _mm_mul_ps(v, o.v); }
+    Float4 operator /(const Float4 &o) const { return _mm_div_ps(v, o.v); }
+    Float4 operator -() const { return _mm_xor_ps(v, _mm_set1_ps(-0.f)); }
+
+    Mask4 operator <(const Float4 &o) const { return _mm_cmplt_ps(v, o.v); }
+    Mask4 operator >(const Float4 &o) const { return _mm_cmpgt_ps(v, o.v); }
+    Mask4 operator <=(const Float4 &o) const { return _mm_cmple_ps(v, o.v); }
+    Mask4 operator >=(const Float4 &o) const { return _mm_cmpge_ps(v, o.v); }
+    Mask4 operator !=(const Float4 &o) const
+	{ return _mm_cmpneq_ps(v, o.v); }
+
+    friend Float4 Min(const Float4 &a, const Float4 &b)
+	{ return _mm_min_ps(a.v, b.v); }
+    friend Float4 Max(const Float4 &a, const Float4 &b)
+	{ return _mm_max_ps(a.v, b.v); }
+    friend Float4 Abs(const Float4 &a)
+	{ return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+    friend Float4 Sqrt(const Float4 &a) { return _mm_sqrt_ps(a.v); }
+
+    // 1 / sqrt(a), from the hardware estimate refined by a Newton step: about
+    // 22 bits, and not the same on every processor
+    friend Float4 RSqrt(const Float4 &a)
+	{ const __m128 e = _mm_rsqrt_ps(a.v);
+	  return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(.5f), e),
+			    _mm_sub_ps(_mm_set1_ps(3.f),
+				       _mm_mul_ps(_mm_mul_ps(a.v, e), e))); }
+
+    // Lanes of a where the mask is set, lanes of b elsewhere
+    friend Float4 Select(const Mask4 &m, const Float4 &a, const Float4 &b)
+	{ return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v)); }
+#else // !PODZ_SIMD_SSE
+    float v[4];
+
+    Float4() {}
+    Float4(const float f) { v[0] = v[1] = v[2] = v[3] = f; }
+    Float4(const float f0, const float f1, const float f2, const float f3)
+        { v[0] = f0, v[1] = f1, v[2] = f2, v[3] = f3; }
+
+    float Get(const int lane) const { return v[lane]; }
+
+    static Float4 Load(const float *const p)
+	{ Float4 r; r.v[0] = p[0], r.v[1] = p[1], r.v[2] = p[2],
+	  r.v[3] = p[3]; return r; }
+    void Store(float *const p) const
+	{ p[0] = v[0], p[1] = v[1], p[2] = v[2], p[3] = v[3]; }
+    static Float4 LoadUnaligned(const float *const p) { return Load(p); }
+    void StoreUnaligned(float *const p) const { Store(p); }
+
+# define PODZ_FLOAT4_OP(op) \
+    Float4 operator op(const Float4 &o) const \
+	{ Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] op o.v[i]; \
+	  return r; }
+# define PODZ_FLOAT4_CMP(op) \
+    Mask4 operator op(const Float4 &o) const \
+	{ return Mask4(v[0] op o.v[0], v[1] op o.v[1], \
+		       v[2] op o.v[2], v[3] op o.v[3]); }
+    PODZ_FLOAT4_OP(+)
+    PODZ_FLOAT4_OP(-)
+    PODZ_FLOAT4_OP(*)
+    PODZ_FLOAT4_OP(/)
+    PODZ_FLOAT4_CMP(<)
+    PODZ_FLOAT4_CMP(>)
+    PODZ_FLOAT4_CMP(<=)
+    PODZ_FLOAT4_CMP(>=)
+    PODZ_FLOAT4_CMP(!=)
+# undef PODZ_FLOAT4_OP
+# undef PODZ_FLOAT4_CMP
+
+    Float4 operator -() const
+	{ Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = -v[i]; return r; }
+
+    friend Float4 Min(const Float4 &a, const Float4 &b)
+	{ Float4 r; for (int i = 0; i < 4; ++i)
+	  r.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return r; }
+    friend Float4 Max(const Float4 &a, const Float4 &b)
+	{ Float4 r; for (int i = 0; i < 4; ++i)
+	  r.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i]; return r; }
+    friend Float4 Abs(const Float4 &a)
+	{ Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = fabsf(a.v[i]);
+	  return r; }
+    friend Float4 Sqrt(const Float4 &a)
+	{ Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = sqrtf(a.v[i]);
+	  return r; }
+    friend Float4 RSqrt(const Float4 &a)
+	{ Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = 1.f / sqrtf(a.v[i]);
+	  return r; }
+
+    friend Float4 Select(const Mask4 &m, const Float4 &a, const Float4 &b)
+	{ Float4 r; for (int i = 0; i < 4; ++i)
+	  r.v[i] = m.m[i] ? a.v[i] : b.v[i]; return r; }
+#endif // !PODZ_SIMD_SSE
+};
+
+} // namespace Podz
+
+#endif // !PODZ_SIMD_H
+
+// End of File
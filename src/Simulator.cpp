@@ -0,0 +1,624 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Simulator.cpp
+ * Description: Headless Simulation Program
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// Windows
+#ifdef _WIN32
+# define DIRSEP "\\"
+#else // !_WIN32
+# define DIRSEP "/"
+#endif // !_WIN32
+
+// STL
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// System
+#include <cstdlib>
+#include <cstring>
+
+// This module
+#include "Clock.h"
+#include "Track.h"
+#include "Pod.h"
+#include "PodBatch.h"
+#include "Pilot.h"
+#include "Race.h"
+#include "ThreadPool.h"
+#include "Environment.h"
+#include "Replay.h"
+#include "RacingLine.h"
+#include "Server.h"
+#include "Client.h"
+
+
+namespace Podz {
+
+// One line of an input script: an input held for a number of ticks
+struct ScriptEntry {
+    int ticks;
+    unsigned input;
+};
+
+// Script lines are "<ticks> <keys>", keys being any of 'A' (accelerate),
+// 'B' (brake), 'L' (left) and 'R' (right), or '-' for none; '#' starts a
+// comment.  The script is repeated until the simulation ends.
+static bool LoadScript(const char *const filename,
+		       std::vector<ScriptEntry> &script)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+	return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+	const std::string::size_type comment = line.find('#');
+	if (comment != std::string::npos)
+	    line.erase(comment);
+
+	std::istringstream stream(line);
+	ScriptEntry entry;
+	std::string keys;
+	if (!(stream >> entry.ticks))
+	    continue;
+	if (!(stream >> keys) || entry.ticks < 0)
+	    return false;
+
+	entry.input = 0;
+	for (std::string::size_type i = 0; i < keys.size(); ++i) {
+	    switch (keys[i]) {
+	    case 'A': case 'a': entry.input |= Pod::INPUT_ACCELERATE; break;
+	    case 'B': case 'b': entry.input |= Pod::INPUT_BRAKE;      break;
+	    case 'L': case 'l': entry.input |= Pod::INPUT_LEFT;       break;
+	    case 'R': case 'r': entry.input |= Pod::INPUT_RIGHT;      break;
+	    case '-': break;
+	    default: return false;
+	    }
+	}
+
+	if (entry.ticks > 0)
+	    script.push_back(entry);
+    }
+
+    return true;
+}
+
+static int Usage(const char *const name)
+{
+    std::cerr << "Usage: " << name
+	      << " [-a | -b | -e | -i REPLAY | -N SERVER] [-j THREADS]"
+		 " [-r RATE] [-n TICKS] [-p PODS] [-k CLASS] [-s SCRIPT]"
+		 " [-w REPLAY] [-c LOG | -C LOG] [-L LOADS] [LEVEL]"
+	      << std::endl;
+    return EXIT_FAILURE;
+}
+
+// Clients (-N) joining a server, one per pod, in real time: each one
+// drives the pod it is given with a pilot, from the snapshots it receives
+static int RunClients(const Track &track, const unsigned levelHash,
+		      const RacingLine &racing, const char *const address,
+		      const int rate, const int ticks, const int nb_clients)
+{
+    std::vector<Client *> clients(nb_clients);
+    std::vector<Race *> races(nb_clients);
+    std::vector<Pilot *> pilots(nb_clients);
+    std::vector<Pod *> pods;
+    bool connected = true;
+    for (int c = 0; c < nb_clients; ++c) {
+	clients[c] = new Client(track, levelHash, rate);
+	connected = clients[c]->Connect(address) && connected;
+	races[c] = new Race(track);
+	for (int i = 0; i < Server::MAX_VISIBLE; ++i) {
+	    pods.push_back(new Pod(track));
+	    races[c]->AddPod(*pods.back());
+	}
+	pilots[c] = new Pilot(track, 0.f, 1.f, &racing);
+    }
+
+    const double dt = 1. / static_cast<double>(rate);
+    double next = Clock::GetTime();
+    int refused = 0, updates = 0;
+    for (int tick = 0; connected && tick < ticks; ++tick) {
+	Clock::Sleep(next - Clock::GetTime());
+	next += dt;
+
+	refused = 0;
+	for (int c = 0; c < nb_clients; ++c) {
+	    Client &client = *clients[c];
+	    if (client.Receive()) {
+		client.Apply(*races[c]);
+		++updates;
+	    }
+	    refused += client.IsRefused();
+	    client.Send(client.IsConnected() ?
+			pilots[c]->Decide(races[c]->GetPod(0)) : 0u);
+	}
+    }
+
+    if (!connected)
+	std::cerr << "Error: could not connect to '" << address << "'."
+		  << std::endl;
+    else {
+	std::cout << "Server:        " << address << ", " << nb_clients
+		  << " clients for " << ticks << " ticks at " << rate
+		  << " Hz (" << refused << " refused, " << updates
+		  << " snapshots)\n";
+	for (int c = 0; c < nb_clients; ++c) {
+	    const Pod &pod = races[c]->GetPod(0);
+	    std::cout << "Client " << c << ":      ";
+	    if (clients[c]->IsConnected())
+		std::cout << "pod " << clients[c]->GetPod() << ", lap "
+			  << pod.GetLap() << ", lap position "
+			  << pod.GetLapPosition() << ", ";
+	    else
+		std::cout << "not connected, ";
+	    std::cout << static_cast<double>(clients[c]->GetBytesReceived())
+			 / (ticks > 0 ? ticks : 1) << " bytes/tick\n";
+	}
+	std::cout.flush();
+    }
+
+    for (int c = 0; c < nb_clients; ++c) {
+	delete clients[c];
+	delete races[c];
+	delete pilots[c];
+    }
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	delete pods[i];
+
+    return connected && refused == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Command line options
+struct Options {
+    int rate, ticks, nb_pods, threads, loads;
+    bool batched, piloted, environment;
+    const char *scriptFile, *level;
+    const char *replayFile, *recordFile;
+    const char *logFile, *compareFile, *server;
+    Pod::Class podClass;
+};
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+    options.rate = 100;
+    options.ticks = 100000;
+    options.nb_pods = 1;
+    options.threads = options.loads = 0;
+    options.batched = options.piloted = options.environment = false;
+    options.scriptFile = options.level = 0;
+    options.replayFile = options.recordFile = 0;
+    options.logFile = options.compareFile = options.server = 0;
+    options.podClass = Pod::CLASS_STANDARD;
+
+    for (int i = 1; i < argc; ++i) {
+	if (argv[i][0] != '-' && options.level == 0)
+	    options.level = argv[i];
+	else if (std::strcmp(argv[i], "-a") == 0)
+	    options.piloted = true;
+	else if (std::strcmp(argv[i], "-b") == 0)
+	    options.batched = true;
+	else if (std::strcmp(argv[i], "-e") == 0)
+	    options.environment = true;
+	else if (i + 1 >= argc)
+	    return false;
+	else if (std::strcmp(argv[i], "-r") == 0)
+	    options.rate = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-n") == 0)
+	    options.ticks = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-j") == 0)
+	    options.threads = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-p") == 0)
+	    options.nb_pods = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-k") == 0) {
+	    if (!Pod::FindClass(argv[++i], options.podClass))
+		return false;
+	} else if (std::strcmp(argv[i], "-s") == 0)
+	    options.scriptFile = argv[++i];
+	else if (std::strcmp(argv[i], "-i") == 0)
+	    options.replayFile = argv[++i];
+	else if (std::strcmp(argv[i], "-w") == 0)
+	    options.recordFile = argv[++i];
+	else if (std::strcmp(argv[i], "-c") == 0)
+	    options.logFile = argv[++i];
+	else if (std::strcmp(argv[i], "-C") == 0)
+	    options.compareFile = argv[++i];
+	else if (std::strcmp(argv[i], "-N") == 0)
+	    options.server = argv[++i];
+	else if (std::strcmp(argv[i], "-L") == 0)
+	    options.loads = std::atoi(argv[++i]);
+	else
+	    return false;
+    }
+
+    const bool replayed = options.replayFile != 0;
+    const bool checked = options.logFile != 0 || options.compareFile != 0;
+    return options.rate > 0 && options.ticks >= 0 && options.nb_pods > 0 &&
+	options.threads >= 0 && options.loads >= 0 &&
+	options.piloted + options.batched + options.environment + replayed +
+	(options.server != 0) <= 1 &&
+	(options.recordFile == 0 || options.piloted) &&
+	(options.logFile == 0 || options.compareFile == 0) &&
+	(!checked || options.piloted || replayed) &&
+	// Only standard pods are batched, recorded and sent over the network
+	(options.podClass == Pod::CLASS_STANDARD ||
+	 !(options.batched || options.environment || replayed ||
+	   options.server != 0 || options.recordFile != 0));
+}
+
+// Race checksums (-c and -C), one line "<tick> <checksum>" per tick:
+// either logged, or compared to a previous log to find where two runs
+// diverge
+class ChecksumLog
+{
+public:
+    ChecksumLog() : compareFile(0), diverged(-1) {}
+
+    bool Open(const char *const logFile, const char *const cmpFile);
+    void Check(const Race &race);
+    void Close(const int ticks);
+    void Report() const;
+
+    bool HasDiverged() const { return diverged >= 0; }
+
+private:
+    std::ofstream log;
+    std::ifstream compare;
+    const char *compareFile;
+    int diverged; // Tick of the first difference, or -1
+};
+
+bool ChecksumLog::Open(const char *const logFile, const char *const cmpFile)
+{
+    if (logFile != 0)
+	log.open(logFile);
+    else if (cmpFile != 0)
+	compare.open(cmpFile);
+    if ((logFile != 0 && !log.is_open()) ||
+	(cmpFile != 0 && !compare.is_open())) {
+	std::cerr << "Error: could not open checksum log '"
+		  << (logFile != 0 ? logFile : cmpFile) << "'."
+		  << std::endl;
+	return false;
+    }
+
+    compareFile = cmpFile;
+    return true;
+}
+
+void ChecksumLog::Check(const Race &race)
+{
+    if (log.is_open())
+	log << race.GetTick() << ' ' << std::hex << race.GetChecksum()
+	    << std::dec << '\n';
+    else if (compare.is_open() && diverged < 0) {
+	int logged = -1;
+	unsigned expected = 0;
+	if (!(compare >> logged >> std::hex >> expected >> std::dec) ||
+	    logged != race.GetTick() || expected != race.GetChecksum())
+	    diverged = race.GetTick();
+    }
+}
+
+void ChecksumLog::Close(const int ticks)
+{
+    int extra;
+    if (compare.is_open() && diverged < 0 && compare >> extra)
+	diverged = ticks + 1; // The log is longer
+}
+
+void ChecksumLog::Report() const
+{
+    if (!compare.is_open())
+	return;
+
+    if (diverged < 0)
+	std::cout << "Checksums:     same as '" << compareFile << "'"
+		  << std::endl;
+    else
+	std::cout << "Checksums:     diverged from '" << compareFile
+		  << "' at tick " << diverged << std::endl;
+}
+
+// Loads the given level or, without one, the first found in the same
+// places as the game looks; the level is also hashed, for replays and
+// clients
+static Track *LoadLevel(const char *&level, ThreadPool &threadPool,
+			unsigned &levelHash)
+{
+    static const char *const levels[] = {
+#ifdef DATA_DIR
+	DATA_DIR DIRSEP "level.txt",
+#endif // DATA_DIR
+	"data" DIRSEP "level.txt", ".." DIRSEP "data" DIRSEP "level.txt"
+    };
+
+    Track *track = 0;
+    if (level != 0)
+	track = new Track(level, &threadPool);
+    else {
+	for (unsigned i = 0; i < sizeof(levels) / sizeof(*levels); ++i) {
+	    delete track;
+	    track = new Track(level = levels[i], &threadPool);
+	    if (track->IsLoaded())
+		break;
+	}
+    }
+
+    if (!track->IsLoaded() || !Replay::HashLevel(level, levelHash)) {
+	std::cerr << "Error: could not load level '" << level << "'."
+		  << std::endl;
+	delete track;
+	return 0;
+    }
+    return track;
+}
+
+// Replays (-i) bring their own rate, duration and number of pods, and must
+// have been recorded on the same level
+static bool LoadReplay(const char *const filename, const unsigned levelHash,
+		       Replay &replay, Options &options)
+{
+    if (!replay.Load(filename)) {
+	std::cerr << "Error: could not load replay '" << filename << "' ("
+		  << Replay::GetErrorString(replay.GetError()) << ")."
+		  << std::endl;
+	return false;
+    }
+    if (replay.GetLevelHash() != levelHash) {
+	std::cerr << "Error: replay recorded on another level." << std::endl;
+	return false;
+    }
+
+    options.rate = replay.GetRate();
+    options.ticks = replay.GetTickCount();
+    options.nb_pods = replay.GetOpponents() + 1;
+    return true;
+}
+
+static int Simulate(int argc, char **argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+	return Usage(argv[0]);
+    const bool batched = options.batched, piloted = options.piloted;
+    const bool environment = options.environment;
+    const bool replayed = options.replayFile != 0;
+    const char *const recordFile = options.recordFile;
+
+    ChecksumLog checksums;
+    if (!checksums.Open(options.logFile, options.compareFile))
+	return EXIT_FAILURE;
+
+    std::vector<ScriptEntry> script;
+    if (options.scriptFile != 0 && !LoadScript(options.scriptFile, script)) {
+	std::cerr << "Error: could not load script '" << options.scriptFile
+		  << "'." << std::endl;
+	return EXIT_FAILURE;
+    }
+    if (script.empty()) {
+	// Default script: full throttle
+	const ScriptEntry entry = { 1, Pod::INPUT_ACCELERATE };
+	script.push_back(entry);
+    }
+
+    ThreadPool threadPool(options.threads);
+    const char *level = options.level;
+    unsigned levelHash = 0;
+    Track *const track = LoadLevel(level, threadPool, levelHash);
+    if (track == 0)
+	return EXIT_FAILURE;
+
+    // Level loading benchmark (-L): the level is loaded again that many times
+    double loadTime = 0.;
+    if (options.loads > 0) {
+	const double loadStart = Clock::GetTime();
+	for (int i = 0; i < options.loads; ++i) {
+	    const Track reloaded(level, &threadPool);
+	}
+	loadTime = (Clock::GetTime() - loadStart) / options.loads;
+    }
+
+    Replay replay;
+    if (replayed && !LoadReplay(options.replayFile, levelHash, replay,
+				options)) {
+	delete track;
+	return EXIT_FAILURE;
+    }
+    const int rate = options.rate, ticks = options.ticks;
+    const int nb_pods = options.nb_pods;
+
+    RacingLine racing(*track);
+    racing.Load(RacingLine::GetFileName(level).c_str());
+    if (options.server != 0) {
+	const int result = RunClients(*track, levelHash, racing,
+				      options.server, rate, ticks, nb_pods);
+	delete track;
+	return result;
+    }
+    if (recordFile != 0)
+	replay.Start(rate, levelHash, nb_pods - 1);
+
+    // Either independent pods, a single batch (-b) holding all of them, a
+    // race (-a) between pods driven by pilots instead of the script, a
+    // training environment (-e) running one episode per pod, or a replay
+    // (-i) of the first pod racing against the opponents
+    std::vector<Pod *> pods;
+    PodBatch *batch = 0;
+    ThreadPool *pool = 0;
+    Race *race = 0;
+    Environment *env = 0;
+    std::vector<unsigned> inputs(nb_pods);
+    std::vector<float> observations, rewards;
+    std::vector<unsigned char> dones;
+    if (batched)
+	batch = new PodBatch(*track, nb_pods);
+    else if (environment) {
+	pool = &threadPool;
+	env = new Environment(*track, nb_pods, rate, 0, pool);
+	observations.resize(nb_pods * Environment::OBSERVATION_SIZE);
+	rewards.resize(nb_pods);
+	dones.resize(nb_pods);
+	env->Reset(&observations[0]);
+    } else {
+	pods.resize(nb_pods);
+	for (int i = 0; i < nb_pods; ++i)
+	    pods[i] = new Pod(*track, options.podClass);
+    }
+    if (piloted || replayed) {
+	pool = &threadPool;
+	race = new Race(*track, pool);
+	race->AddPod(*pods[0], piloted ? new Pilot(*track, 0.f, 1.f, &racing)
+				       : 0);
+	for (int i = 1; i < nb_pods; ++i)
+	    race->AddPod(*pods[i], Pilot::CreateOpponent(*track, i - 1,
+							 &racing));
+    }
+
+    const float dt = 1.f / static_cast<float>(rate);
+    std::vector<ScriptEntry>::size_type entry = 0;
+    int remaining = script[0].ticks;
+
+    const double start = Clock::GetTime();
+    for (int tick = 0; tick < ticks; ++tick) {
+	const unsigned input = script[entry].input;
+	if (piloted) {
+	    race->Step(dt);
+	    if (recordFile != 0)
+		replay.Record(race->GetInput(0));
+	} else if (replayed) {
+	    unsigned played = 0;
+	    replay.Play(played);
+	    race->SetInput(0, played);
+	    race->Step(dt);
+	} else if (environment) {
+	    std::fill(inputs.begin(), inputs.end(), input);
+	    env->Step(&inputs[0], &observations[0], &rewards[0], &dones[0]);
+	} else if (batched) {
+	    std::fill(inputs.begin(), inputs.end(), input);
+	    batch->Step(&inputs[0], dt);
+	} else {
+	    for (int i = 0; i < nb_pods; ++i)
+		pods[i]->Step(input, dt);
+	}
+
+	if (race != 0)
+	    checksums.Check(*race);
+
+	if (--remaining == 0) {
+	    if (++entry == script.size())
+		entry = 0;
+	    remaining = script[entry].ticks;
+	}
+    }
+    const double elapsed = Clock::GetTime() - start;
+    checksums.Close(ticks);
+
+    int laps = 0;
+    for (int i = 0; i < nb_pods; ++i)
+	laps += (batched ? batch->GetLap(i) : environment ?
+		 env->GetPod(i).GetLap() : pods[i]->GetLap()) - 1;
+
+    const double podTicks = static_cast<double>(ticks) * nb_pods;
+    const Pod *const first = batched ? 0 : environment ? &env->GetPod(0)
+					  : pods[0];
+    const Vector position = batched ? batch->GetPosition(0)
+				    : first->GetPosition();
+    const Vector speed = batched ? batch->GetSpeed(0) : first->GetSpeed();
+    const int lap = batched ? batch->GetLap(0) : first->GetLap();
+    const float lapPosition = batched ? batch->GetLapPosition(0)
+				      : first->GetLapPosition();
+    const float circPosition = batched ? batch->GetCircPosition(0)
+				       : first->GetCircPosition();
+    std::cout << "Level:         " << level << " (length "
+	      << track->GetTotalLength() << ", "
+	      << track->GetSegmentCount() << " segments, "
+	      << static_cast<double>(track->GetMemorySize()) / 1024.
+	      << " KiB)\n"
+	      << "Simulated:     " << ticks << " ticks x " << nb_pods
+	      << (batched ? " batched" : piloted ? " piloted" :
+		  environment ? " environment" : replayed ? " replayed" : "")
+	      << ' ' << Pod::GetClassName(options.podClass) << " pods at "
+	      << rate << " Hz ("
+	      << static_cast<double>(ticks) / rate << " s)\n";
+    if (options.loads > 0)
+	std::cout << "Level loading: " << loadTime * 1e3 << " ms\n";
+    if (pool != 0)
+	std::cout << "Threads:       " << pool->GetThreadCount() << '\n';
+    std::cout << "Wall time:     " << elapsed << " s\n"
+	      << "Throughput:    " << (elapsed > 0. ? podTicks / elapsed : 0.)
+	      << " ticks/s, " << (elapsed > 0. ? laps / elapsed : 0.)
+	      << " laps/s\n"
+	      << "Final state:   pod 0, lap " << lap
+	      << (lap > Pod::LAP_NUM ? " (finished)" : "")
+	      << ", lap position " << lapPosition
+	      << ", circuit position " << circPosition << '\n'
+	      << "               position (" << position.x << ", "
+	      << position.y << ", " << position.z << "), speed "
+	      << speed.Length() << " u/s" << std::endl;
+    checksums.Report();
+
+    if (recordFile != 0) {
+	if (replay.Save(recordFile))
+	    std::cout << "Recorded:      " << replay.GetRunCount()
+		      << " input runs to '" << recordFile << "'" << std::endl;
+	else
+	    std::cerr << "Error: could not save replay '" << recordFile
+		      << "'." << std::endl;
+    }
+
+    delete race;
+    delete env;
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	delete pods[i];
+    delete batch;
+    delete track;
+
+    return checksums.HasDiverged() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace Podz
+
+
+extern "C" int main(int argc, char **argv)
+{
+    return Podz::Simulate(argc, argv);
+}
+
+// End of File
@@ -0,0 +1,204 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Snapshot.cpp
+ * Description: Quantized Race Snapshot
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Basis.h"
+#include "Track.h"
+#include "Pod.h"
+#include "Packet.h"
+#include "Snapshot.h"
+
+
+namespace Podz {
+
+static const float PI = static_cast<float>(M_PI);
+
+// Quantization steps: 4 mm, 1/64 u/s, 1/65536 turn
+static const float POSITION_SCALE = 256.f;
+static const float SPEED_SCALE = 64.f;
+static const float ANGLE_SCALE = 32768.f / PI;
+static const float SLOPE_SCALE = 4096.f;
+static const float ACCELERATION_SCALE = 64.f;
+
+enum { FLAG_ACCELERATED = 1 << 0, FLAG_WRONG_WAY = 1 << 1 };
+
+// At most that many pods in a snapshot
+static const unsigned MAX_SAMPLES = 256;
+
+static inline int Quantize(const float value, const float scale)
+{
+    return static_cast<int>(floorf(value * scale + .5f));
+}
+
+static inline float Dequantize(const int value, const float scale)
+{
+    return static_cast<float>(value) / scale;
+}
+
+void Snapshot::Add(const int pod, const Pod &state)
+{
+    const Basis &basis = state.GetBasis();
+    const Vector local = basis.RevertPoint(state.GetPosition());
+    const Vector speed = basis.RevertVector(state.GetSpeed());
+
+    // The angle only matters modulo a turn
+    float angle = fmodf(state.GetAngle(), 2.f * PI);
+    if (angle >= PI)
+	angle -= 2.f * PI;
+    else if (angle < -PI)
+	angle += 2.f * PI;
+
+    Sample sample;
+    sample.pod = pod;
+    int *const fields = sample.fields;
+    fields[CIRC_POSITION] = Quantize(state.GetCircPosition(), POSITION_SCALE);
+    fields[OFFSET] = Quantize(local.x, POSITION_SCALE);
+    fields[HEIGHT] = Quantize(local.y, POSITION_SCALE);
+    fields[SPEED_RIGHT] = Quantize(speed.x, SPEED_SCALE);
+    fields[SPEED_UP] = Quantize(speed.y, SPEED_SCALE);
+    fields[SPEED_BACKWARD] = Quantize(speed.z, SPEED_SCALE);
+    fields[ANGLE] = Quantize(angle, ANGLE_SCALE);
+    fields[SLOPE] = Quantize(state.GetSlope(), SLOPE_SCALE);
+    fields[ACCELERATION] = Quantize(state.GetAcceleration(),
+				    ACCELERATION_SCALE);
+    fields[LAP] = state.GetLap();
+    fields[FLAGS] = (state.IsAccelerated() ? FLAG_ACCELERATED : 0) |
+		    (state.IsWrongWay() ? FLAG_WRONG_WAY : 0);
+
+    samples.push_back(sample);
+}
+
+const Snapshot::Sample *Snapshot::Find(const int pod) const
+{
+    // Snapshots hold a few pods: no need for anything faster
+    for (std::vector<Sample>::size_type i = 0; i < samples.size(); ++i)
+	if (samples[i].pod == pod)
+	    return &samples[i];
+    return 0;
+}
+
+void Snapshot::Write(Packet &packet, const Snapshot *const base) const
+{
+    static const Sample none = { -1, { 0 } };
+
+    packet.WriteNumber(static_cast<unsigned>(samples.size()));
+    for (std::vector<Sample>::size_type i = 0; i < samples.size(); ++i) {
+	const Sample &sample = samples[i];
+	const Sample *reference = base != 0 ? base->Find(sample.pod) : 0;
+	if (reference == 0)
+	    reference = &none;
+
+	// Pod, mask of the changed fields, then their differences
+	unsigned mask = 0;
+	for (int f = 0; f < FIELD_NUM; ++f)
+	    if (sample.fields[f] != reference->fields[f])
+		mask |= 1u << f;
+	packet.WriteNumber(static_cast<unsigned>(sample.pod));
+	packet.WriteNumber(mask);
+	for (int f = 0; f < FIELD_NUM; ++f)
+	    if (mask & (1u << f))
+		packet.WriteSigned(sample.fields[f] - reference->fields[f]);
+    }
+}
+
+bool Snapshot::Read(Packet &packet, const int tck, const Snapshot *const base)
+{
+    static const Sample none = { -1, { 0 } };
+
+    Clear(tck);
+    const unsigned count = packet.ReadNumber();
+    if (packet.HasError() || count > MAX_SAMPLES)
+	return false;
+
+    for (unsigned i = 0; i < count; ++i) {
+	Sample sample;
+	sample.pod = static_cast<int>(packet.ReadNumber());
+	const unsigned mask = packet.ReadNumber();
+	if (packet.HasError() || sample.pod < 0 || mask >> FIELD_NUM != 0)
+	    return false;
+
+	const Sample *reference = base != 0 ? base->Find(sample.pod) : 0;
+	if (reference == 0)
+	    reference = &none;
+	for (int f = 0; f < FIELD_NUM; ++f)
+	    sample.fields[f] = reference->fields[f] +
+			       (mask & (1u << f) ? packet.ReadSigned() : 0);
+	samples.push_back(sample);
+    }
+
+    return !packet.HasError();
+}
+
+void Snapshot::Restore(const Track &track, const Sample &sample,
+		       Pod::State &state, int *const hint)
+{
+    const int *const fields = sample.fields;
+    int cursor = hint != 0 ? *hint : 0;
+
+    state.circPosition = Dequantize(fields[CIRC_POSITION], POSITION_SCALE);
+    state.basis = track.GetBasis(state.circPosition, &cursor);
+    state.position = state.basis.TransformPoint(Vector(
+	    Dequantize(fields[OFFSET], POSITION_SCALE),
+	    Dequantize(fields[HEIGHT], POSITION_SCALE), 0.f));
+    state.speed = state.basis.TransformVector(Vector(
+	    Dequantize(fields[SPEED_RIGHT], SPEED_SCALE),
+	    Dequantize(fields[SPEED_UP], SPEED_SCALE),
+	    Dequantize(fields[SPEED_BACKWARD], SPEED_SCALE)));
+    state.angle = Dequantize(fields[ANGLE], ANGLE_SCALE);
+    state.direction = state.basis.TransformVector(Vector(0.f, 0.f, -1.f)
+	    .Rotate(0.f, state.angle, 0.f));
+    state.slope = Dequantize(fields[SLOPE], SLOPE_SCALE);
+    state.acceleration = Dequantize(fields[ACCELERATION], ACCELERATION_SCALE);
+    state.lap = fields[LAP];
+    state.accelerated = (fields[FLAGS] & FLAG_ACCELERATED) != 0;
+    state.wrongWay = (fields[FLAGS] & FLAG_WRONG_WAY) != 0;
+
+    // The lap position is the circuit one, less the completed laps
+    state.lapPosition = state.circPosition - static_cast<float>(state.lap - 1)
+					   * track.GetTotalLength();
+    state.circCursor = cursor;
+    state.circOffset = 0.f;
+    if (hint != 0)
+	*hint = cursor;
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,99 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Snapshot.h
+ * Description: Quantized Race Snapshot (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_SNAPSHOT_H
+#define PODZ_SNAPSHOT_H
+
+#include <vector>
+
+#include "Pod.h"
+
+namespace Podz
+{
+
+class Track;
+class Packet;
+
+// State of some pods of a race at a given tick, as sent over the network:
+// each pod is quantized to integers in the frame of the track where it
+// stands (distance along the track, offset across and height above it),
+// which keeps the numbers small and precise whatever the size of the
+// circuit.  A snapshot is written as differences with a previous one
+// that the receiver already has, so that a field costs nothing when it
+// does not change and a byte or two when it does.
+class Snapshot
+{
+public:
+    enum Field {
+	CIRC_POSITION = 0, OFFSET, HEIGHT,
+	SPEED_RIGHT, SPEED_UP, SPEED_BACKWARD,
+	ANGLE, SLOPE, ACCELERATION, LAP, FLAGS,
+	FIELD_NUM
+    };
+
+    // Snapshots kept by each side as bases for the next ones, in ticks
+    enum { HISTORY = 32 };
+
+    struct Sample {
+	int pod;
+	int fields[FIELD_NUM];
+    };
+
+    Snapshot() : tick(-1) {}
+
+    void Clear(const int tck) { tick = tck; samples.clear(); }
+    void Add(const int pod, const Pod &state);
+    void Add(const Sample &sample) { samples.push_back(sample); }
+
+    int GetTick() const { return tick; }
+    int GetCount() const { return static_cast<int>(samples.size()); }
+    const Sample &GetSample(const int index) const { return samples[index]; }
+    const Sample *Find(const int pod) const;
+
+    // Pods missing from the base are written in full; reading needs the
+    // same base as writing
+    void Write(Packet &packet, const Snapshot *const base) const;
+    bool Read(Packet &packet, const int tck, const Snapshot *const base);
+
+    // Back to a full pod state, the hint being a track segment cursor
+    static void Restore(const Track &track, const Sample &sample,
+			Pod::State &state, int *const hint = 0);
+
+private:
+    int tick;
+    std::vector<Sample> samples;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_SNAPSHOT_H
+
+// End of File
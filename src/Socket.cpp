@@ -0,0 +1,191 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Socket.cpp
+ * Description: UDP Socket
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN 1
+# include <winsock2.h>
+# define close closesocket
+typedef int socklen_t;
+#else // !_WIN32
+# include <sys/types.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+# include <netdb.h>
+# include <fcntl.h>
+# include <unistd.h>
+# define INVALID_SOCKET (-1)
+#endif // !_WIN32
+
+// STL
+#include <string>
+
+// This module
+#include "Socket.h"
+
+
+namespace Podz {
+
+Socket::Socket()
+    : handle(INVALID_SOCKET)
+{}
+
+Socket::~Socket()
+{
+    Close();
+}
+
+bool Socket::Open(const unsigned short port)
+{
+    Close();
+
+#ifdef _WIN32
+    static bool started = false;
+    if (!started) {
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+	    return false;
+	started = true;
+    }
+#endif // _WIN32
+
+    handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET)
+	return false;
+
+    struct sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+
+#ifdef _WIN32
+    u_long nonblocking = 1;
+    const bool ok = ioctlsocket(handle, FIONBIO, &nonblocking) == 0;
+#else // !_WIN32
+    const int flags = fcntl(handle, F_GETFL, 0);
+    const bool ok = flags != -1 &&
+		    fcntl(handle, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif // !_WIN32
+    if (!ok || bind(handle, reinterpret_cast<struct sockaddr *>(&local),
+		    sizeof(local)) != 0) {
+	Close();
+	return false;
+    }
+
+    return true;
+}
+
+void Socket::Close()
+{
+    if (handle != INVALID_SOCKET) {
+	close(handle);
+	handle = INVALID_SOCKET;
+    }
+}
+
+bool Socket::IsOpen() const
+{
+    return handle != INVALID_SOCKET;
+}
+
+bool Socket::Send(const Address &to, const void *const data, const int size)
+{
+    struct sockaddr_in remote;
+    std::memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = htonl(to.host);
+    remote.sin_port = htons(to.port);
+
+    return sendto(handle, static_cast<const char *>(data), size, 0,
+		  reinterpret_cast<struct sockaddr *>(&remote),
+		  sizeof(remote)) == size;
+}
+
+int Socket::Receive(Address &from, void *const data, const int size)
+{
+    struct sockaddr_in remote;
+    socklen_t length = sizeof(remote);
+    const int received = recvfrom(handle, static_cast<char *>(data), size, 0,
+				  reinterpret_cast<struct sockaddr *>(&remote),
+				  &length);
+    if (received < 0) {
+#ifdef _WIN32
+	const int error = WSAGetLastError();
+	// A previous datagram was refused: nothing to read, not fatal
+	return error == WSAEWOULDBLOCK || error == WSAECONNRESET ? 0 : -1;
+#else // !_WIN32
+	return errno == EAGAIN || errno == EWOULDBLOCK ||
+	       errno == ECONNREFUSED ? 0 : -1;
+#endif // !_WIN32
+    }
+
+    from.host = ntohl(remote.sin_addr.s_addr);
+    from.port = ntohs(remote.sin_port);
+    return received;
+}
+
+bool Socket::Resolve(const char *const name, Address &address)
+{
+    std::string host(name);
+    address.port = DEFAULT_PORT;
+
+    const std::string::size_type colon = host.rfind(':');
+    if (colon != std::string::npos) {
+	const int port = std::atoi(host.c_str() + colon + 1);
+	if (port <= 0 || port > 65535)
+	    return false;
+	address.port = static_cast<unsigned short>(port);
+	host.erase(colon);
+    }
+
+    const struct hostent *const entry = gethostbyname(host.c_str());
+    if (entry == 0 || entry->h_addrtype != AF_INET || entry->h_length != 4)
+	return false;
+
+    struct in_addr ip;
+    std::memcpy(&ip, entry->h_addr_list[0], sizeof(ip));
+    address.host = ntohl(ip.s_addr);
+    return true;
+}
+
+} // namespace Podz
+
+// End of File
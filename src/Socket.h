@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *	File: src/Socket.h
+ * Description: UDP Socket (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_SOCKET_H
+#define PODZ_SOCKET_H
+
+namespace Podz
+{
+
+// Non-blocking UDP socket, IPv4 only: enough for racing on a local network
+class Socket
+{
+public:
+    // Host and port in host byte order
+    struct Address {
+	unsigned host;
+	unsigned short port;
+
+	bool operator ==(const Address &a) const
+	    { return host == a.host && port == a.port; }
+	bool operator !=(const Address &a) const { return !(*this == a); }
+	bool operator <(const Address &a) const
+	    { return host < a.host || (host == a.host && port < a.port); }
+    };
+
+    enum { DEFAULT_PORT = 27182 };
+
+    Socket();
+    ~Socket();
+
+    // Listens on the given port of all interfaces; 0 for any free port
+    bool Open(const unsigned short port = 0);
+    void Close();
+    bool IsOpen() const;
+
+    bool Send(const Address &to, const void *const data, const int size);
+
+    // Size of the next pending datagram, 0 when there is none, -1 on error
+    int Receive(Address &from, void *const data, const int size);
+
+    // "host" or "host:port", the port defaulting to DEFAULT_PORT
+    static bool Resolve(const char *const name, Address &address);
+
+private:
+#ifdef _WIN32
+    unsigned handle;
+#else // !_WIN32
+    int handle;
+#endif // !_WIN32
+
+    // No copy
+    Socket(const Socket &);
+    void operator =(const Socket &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_SOCKET_H
+
+// End of File
@@ -78,8 +78,8 @@ namespace Podz {
 bool Texture::texturing = true;
 std::list<Texture *> Texture::all;
 
-Texture::Texture(const char *const fname)
-    : filename(fname), id(0)
+Texture::Texture(const char *const fname, const bool repeated)
+    : filename(fname), repeat(repeated), id(0)
 {
     if (!Load(filename))
 	std::cerr << "WARNING: could not load texture '" << filename << "'."
@@ -186,7 +186,8 @@ bool Texture::Load(const char *const filename)
 		      bpp == 24 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, data);
 
     // Set texture parameters
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+		    repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
 		    GL_LINEAR_MIPMAP_LINEAR);
@@ -47,7 +47,9 @@ namespace Podz {
 class Texture
 {
 public:
-    Texture(const char *const filename);
+    // A repeated texture wraps around along its first axis (s), instead of
+    // being clamped to its edge
+    Texture(const char *const filename, const bool repeated = false);
     ~Texture();
 
     bool IsLoaded() const { return id != 0; }
@@ -63,6 +65,7 @@ public:
 
 private:
     const char *filename;
+    bool repeat;
     static bool texturing;
     GLuint id;
 
@@ -0,0 +1,195 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/ThreadPool.cpp
+ * Description: Worker Thread Pool
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// System
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN 1
+# include <windows.h>
+#else // !_WIN32
+# include <unistd.h>
+#endif // !_WIN32
+
+// This module
+#include "ThreadPool.h"
+
+
+namespace Podz {
+
+#ifdef HAVE_PTHREAD_H
+
+ThreadPool::ThreadPool(int threads)
+    : task(0), count(0), next(0), chunk(1), busy(0), generation(0),
+      quit(false)
+{
+    if (threads <= 0)
+	threads = GetProcessorCount();
+    nb_threads = threads;
+
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&wakeup, 0);
+    pthread_cond_init(&done, 0);
+
+    // The calling thread takes part in every loop
+    for (int i = 1; i < threads; ++i) {
+	pthread_t thread;
+	if (pthread_create(&thread, 0, WorkerFunc, this) != 0)
+	    break;
+	workers.push_back(thread);
+    }
+    nb_threads = static_cast<int>(workers.size()) + 1;
+}
+
+ThreadPool::~ThreadPool()
+{
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&wakeup);
+    pthread_mutex_unlock(&mutex);
+
+    for (std::vector<pthread_t>::size_type i = 0; i < workers.size(); ++i)
+	pthread_join(workers[i], 0);
+
+    pthread_cond_destroy(&done);
+    pthread_cond_destroy(&wakeup);
+    pthread_mutex_destroy(&mutex);
+}
+
+void ThreadPool::Run(Task &job, const int nb)
+{
+    if (workers.empty() || nb <= 1) {
+	for (int i = 0; i < nb; ++i)
+	    job.Run(i);
+	return;
+    }
+
+    pthread_mutex_lock(&mutex);
+    task = &job;
+    count = nb;
+    next = 0;
+    // A few chunks per thread, to balance uneven iterations
+    chunk = nb / (nb_threads * 4);
+    if (chunk < 1)
+	chunk = 1;
+    busy = static_cast<int>(workers.size());
+    ++generation;
+    pthread_cond_broadcast(&wakeup);
+    pthread_mutex_unlock(&mutex);
+
+    Work();
+
+    pthread_mutex_lock(&mutex);
+    while (busy > 0)
+	pthread_cond_wait(&done, &mutex);
+    task = 0;
+    pthread_mutex_unlock(&mutex);
+}
+
+void ThreadPool::Work()
+{
+    for (;;) {
+	pthread_mutex_lock(&mutex);
+	const int first = next, last = first + chunk < count ?
+				       first + chunk : count;
+	next = last;
+	Task *const job = task;
+	pthread_mutex_unlock(&mutex);
+
+	if (first >= last)
+	    break;
+	for (int i = first; i < last; ++i)
+	    job->Run(i);
+    }
+}
+
+void *ThreadPool::WorkerFunc(void *data)
+{
+    ThreadPool &pool = *static_cast<ThreadPool *>(data);
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool.mutex);
+    for (;;) {
+	while (!pool.quit && pool.generation == seen)
+	    pthread_cond_wait(&pool.wakeup, &pool.mutex);
+	if (pool.quit)
+	    break;
+	seen = pool.generation;
+	pthread_mutex_unlock(&pool.mutex);
+
+	pool.Work();
+
+	pthread_mutex_lock(&pool.mutex);
+	if (--pool.busy == 0)
+	    pthread_cond_signal(&pool.done);
+    }
+    pthread_mutex_unlock(&pool.mutex);
+
+    return 0;
+}
+
+#else // !HAVE_PTHREAD_H
+
+ThreadPool::ThreadPool(int)
+    : nb_threads(1)
+{}
+
+ThreadPool::~ThreadPool()
+{}
+
+void ThreadPool::Run(Task &job, const int nb)
+{
+    for (int i = 0; i < nb; ++i)
+	job.Run(i);
+}
+
+#endif // !HAVE_PTHREAD_H
+
+int ThreadPool::GetProcessorCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<int>(info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? static_cast<int>(processors) : 1;
+#else // !_WIN32 && !_SC_NPROCESSORS_ONLN
+    return 1;
+#endif // !_WIN32 && !_SC_NPROCESSORS_ONLN
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,100 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/ThreadPool.h
+ * Description: Worker Thread Pool (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_THREADPOOL_H
+#define PODZ_THREADPOOL_H
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+#ifdef HAVE_PTHREAD_H
+# include <pthread.h>
+#endif // HAVE_PTHREAD_H
+
+#include <vector>
+
+
+namespace Podz {
+
+// Fixed set of worker threads running parallel loops; without thread
+// support, loops simply run on the calling thread
+class ThreadPool
+{
+public:
+    // Loop body, run once for every index of the loop
+    class Task
+    {
+    public:
+	virtual ~Task() {}
+	virtual void Run(const int index) = 0;
+    };
+
+    // By default, one thread per processor (the calling thread included)
+    ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    int GetThreadCount() const { return nb_threads; }
+
+    // Run the task for every index in [0, count), in parallel; returns when
+    // all of them are done
+    void Run(Task &task, const int count);
+
+    static int GetProcessorCount();
+
+private:
+    int nb_threads;
+
+#ifdef HAVE_PTHREAD_H
+    std::vector<pthread_t> workers;
+    pthread_mutex_t mutex;
+    pthread_cond_t wakeup, done;
+
+    Task *task;
+    int count, next, chunk;
+    int busy;
+    unsigned generation;
+    bool quit;
+
+    void Work();
+    static void *WorkerFunc(void *pool);
+#endif // HAVE_PTHREAD_H
+
+    // No copy
+    ThreadPool(const ThreadPool &);
+    void operator =(const ThreadPool &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_THREADPOOL_H
+
+// End of File
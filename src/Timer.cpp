@@ -49,15 +49,21 @@
 // This module
 #include "Keyboard.h"
 #include "Display.h"
+#include "Clock.h"
 #include "Timer.h"
 
 namespace Podz
 {
 
+// Longest real time caught up in one frame, to avoid a spiral of death when
+// the machine cannot keep up with the simulation rate
+static const double MAX_LAG = .25;
+
 Timer *Timer::instance = 0;
 
-Timer::Timer(int intervl, Keyboard &kbd)
-    : interval(intervl), time(0), state(BEGIN), keyboard(kbd)
+Timer::Timer(int rate, Keyboard &kbd)
+    : step(1. / rate), time(0.), state(BEGIN), keyboard(kbd),
+      lastClock(0.), accumulator(0.), alpha(1.f)
 {
     instance = this;
 }
@@ -66,7 +72,9 @@ void Timer::Start()
 {
     if (state == BEGIN || state == PAUSE) {
 	state = PLAY;
-	glutTimerFunc(0, TimerFunc, 0);
+	lastClock = Clock::GetTime();
+	accumulator = 0.;
+	glutIdleFunc(IdleFunc);
     }
 }
 
@@ -85,26 +93,49 @@ void Timer::Finish()
 void Timer::Reset()
 {
     state = BEGIN;
-    time = 0;
+    time = 0.;
+    alpha = 1.f;
     glutPostRedisplay();
 }
 
-void Timer::OnTimer(int value)
+void Timer::Rewind(const int tick)
 {
-    if (state != PLAY)
+    if (state != BEGIN)
+	state = PAUSE;
+    time = tick * step;
+    alpha = 1.f;
+    glutPostRedisplay();
+}
+
+void Timer::OnIdle()
+{
+    if (state != PLAY) {
+	glutIdleFunc(0);
 	return;
+    }
 
-    time += interval;
+    const double now = Clock::GetTime();
+    double elapsed = now - lastClock;
+    lastClock = now;
+    if (elapsed > MAX_LAG)
+	elapsed = MAX_LAG;
+
+    // Run as many fixed steps as real time requires
+    accumulator += elapsed;
+    while (accumulator >= step && state == PLAY) {
+	keyboard.CheckKeys(static_cast<float>(step));
+	time += step;
+	accumulator -= step;
+    }
 
-    glutTimerFunc(interval, TimerFunc, value);
-    keyboard.CheckKeys();
+    alpha = state == PLAY ? static_cast<float>(accumulator / step) : 1.f;
     glutPostRedisplay();
 }
 
 void Timer::DisplayOSD()
 {
     char buffer[32];
-    snprintf(buffer, sizeof(buffer), "Time: %d s", time / 1000);
+    snprintf(buffer, sizeof(buffer), "Time: %d s", static_cast<int>(time));
     Display::DisplayText(buffer, -.7f, -.5f);
 
     switch (state) {
@@ -128,12 +159,12 @@ void Timer::DisplayOSD()
 void Timer::RegisterCallbacks()
 {
     if (state == PLAY)
-	glutTimerFunc(interval, TimerFunc, 0);
+	glutIdleFunc(IdleFunc);
 }
 
-void Timer::TimerFunc(int value)
+void Timer::IdleFunc()
 {
-    instance->OnTimer(value);
+    instance->OnIdle();
 }
 
 } // namespace Podz
@@ -44,7 +44,8 @@ class Keyboard;
 class Timer : public Object
 {
 public:
-    Timer(int intervl, Keyboard &kbd);
+    // The simulation runs at the given rate, in ticks per second
+    Timer(int rate, Keyboard &kbd);
 
     virtual void DisplayOSD();
 
@@ -55,20 +56,34 @@ public:
     void Finish();
     void Reset();
 
+    // Back to the time of a past tick, paused
+    void Rewind(const int tick);
+    double GetStep() const { return step; }
+
+    // Race time, in seconds
+    double GetTime() const { return time; }
+
     bool IsPaused() const { return state == PAUSE; }
     bool HasStarted() const { return state != BEGIN; }
     bool HasFinished() const { return state == END; }
 
+    // Fraction of a tick elapsed since the last simulation step, used to
+    // interpolate between the two last simulation states when rendering
+    float GetInterpolation() const { return alpha; }
+
 private:
-    int interval, time;
+    double step, time;
     enum { BEGIN, PAUSE, PLAY, END } state;
     Keyboard &keyboard;
 
-    void OnTimer(int value);
+    double lastClock, accumulator;
+    float alpha;
+
+    void OnIdle();
 
     // GLUT callback
     static Timer *instance;
-    static void TimerFunc(int value);
+    static void IdleFunc();
 
     // No assignment
     void operator =(const Timer &) const;
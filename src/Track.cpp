@@ -0,0 +1,468 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Track.cpp
+ * Description: Circuit Geometry and Track Frame Queries
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// STL
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+// System
+#include <cmath>
+
+// This module
+#include "Vector.h"
+#include "Quaternion.h"
+#include "Basis.h"
+#include "Matrix.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include "Track.h"
+
+namespace Podz {
+
+static const float CIRC_WIDTH = 4.f;
+static const float BORDER_WIDTH = .3f, BORDER_HEIGHT = .8f;
+
+// Tessellation: segments are cut in halves until no longer than
+// MAX_SEG_LENGTH, nowhere further than MAX_ERROR from the curve and turning
+// by less than about 14 degrees, within MAX_DEPTH halvings of a span
+static const float MAX_SEG_LENGTH = 16.f;
+static const float MAX_ERROR = .05f;
+static const float MIN_TURN_COS = .97f;
+static const int MAX_DEPTH = 12;
+
+// Whether two directions differ by more than the allowed turn
+static inline bool Turns(const Vector &a, const Vector &b)
+{
+    return a.DotProduct(b) < MIN_TURN_COS * a.Length() * b.Length();
+}
+
+// Span between two control points: the cubic Hermite curve through them,
+// the tangents being scaled by the chord length, with normals blended
+// linearly (the bases normalize them)
+struct Track::Curve
+{
+    Vector p0, m0, p1, m1, n0, n1;
+
+    Curve(const Point &start, const Point &end, const float chord)
+	: p0(start.point), m0(start.tangent * chord),
+	  p1(end.point), m1(end.tangent * chord),
+	  n0(start.normal), n1(end.normal) {}
+
+    Vector GetPoint(const float t) const
+    {
+	const float t2 = t * t, t3 = t2 * t;
+	return p0 * (2.f * t3 - 3.f * t2 + 1.f) + m0 * (t3 - 2.f * t2 + t)
+	     + p1 * (3.f * t2 - 2.f * t3) + m1 * (t3 - t2);
+    }
+
+    Vector GetTangent(const float t) const
+    {
+	const float t2 = t * t;
+	return p0 * (6.f * t2 - 6.f * t) + m0 * (3.f * t2 - 4.f * t + 1.f)
+	     + p1 * (6.f * t - 6.f * t2) + m1 * (3.f * t2 - 2.f * t);
+    }
+
+    Vector GetNormal(const float t) const { return n0 * (1.f - t) + n1 * t; }
+};
+
+class Track::CountTask : public ThreadPool::Task
+{
+public:
+    CountTask(const Point *const pts, int *const cnts)
+	: points(pts), counts(cnts) {}
+
+    virtual void Run(const int index)
+    {
+	counts[index] = Tessellate(points[index + 1], points[index + 2], 0);
+    }
+
+private:
+    const Point *const points;
+    int *const counts;
+
+    void operator =(const CountTask &) const;
+};
+
+class Track::TessellateTask : public ThreadPool::Task
+{
+public:
+    TessellateTask(const Point *const pts, const int *const frsts,
+		   Segment *const segs)
+	: points(pts), firsts(frsts), segments(segs) {}
+
+    virtual void Run(const int index)
+    {
+	Tessellate(points[index + 1], points[index + 2],
+		   segments + firsts[index]);
+    }
+
+private:
+    const Point *const points;
+    const int *const firsts;
+    Segment *const segments;
+
+    void operator =(const TessellateTask &) const;
+};
+
+Track::Track(const char *const filename, ThreadPool *const pool)
+    : nb_segs(0), segments(0), offsets(0), totalLength(0.f)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+	return;
+
+    int nb_pts;
+    file >> nb_pts;
+    if (!file.good() || nb_pts < 1)
+	return;
+
+    Point *ptTan = new Point[nb_pts + 2];
+
+    for (int i = 1; i <= nb_pts; ++i) {
+	file >> ptTan[i].point.x
+	     >> ptTan[i].point.y
+	     >> ptTan[i].point.z
+	     >> ptTan[i].normal.x
+	     >> ptTan[i].normal.y
+	     >> ptTan[i].normal.z;
+    }
+
+    if (!file.good()) {
+	delete[] ptTan;
+	nb_segs = 0;
+	return;
+    }
+
+    // Normals, then tangents as the mean direction of both neighbouring
+    // chords, normalized in batches
+    std::vector<Vector> normals(nb_pts), chords(nb_pts + 1);
+    for (int i = 0; i < nb_pts; ++i)
+	normals[i] = ptTan[i + 1].normal;
+    VectorBatch::Normalize(&normals[0], nb_pts);
+    for (int i = 0; i < nb_pts; ++i)
+	ptTan[i + 1].normal = normals[i];
+
+    ptTan[nb_pts + 1].point = ptTan[1].point;
+    ptTan[nb_pts + 1].normal = ptTan[1].normal;
+    ptTan[0].point = ptTan[nb_pts].point;
+    ptTan[0].normal = ptTan[nb_pts].normal;
+
+    for (int i = 0; i <= nb_pts; ++i)
+	chords[i] = ptTan[i + 1].point - ptTan[i].point;
+    VectorBatch::Normalize(&chords[0], nb_pts + 1);
+    std::vector<Vector> tangents(nb_pts);
+    for (int i = 0; i < nb_pts; ++i)
+	tangents[i] = chords[i] + chords[i + 1];
+    VectorBatch::Normalize(&tangents[0], nb_pts);
+    for (int i = 0; i < nb_pts; ++i)
+	ptTan[i + 1].tangent = tangents[i];
+    ptTan[nb_pts + 1].tangent = ptTan[1].tangent;
+    ptTan[0].tangent = ptTan[nb_pts].tangent;
+
+    // Every span is tessellated on its own: once the segments of each one
+    // are counted, they go straight to their place in the final array
+    std::vector<int> firsts(nb_pts + 1);
+    CountTask count(ptTan, &firsts[1]);
+    if (pool != 0)
+	pool->Run(count, nb_pts);
+    else
+	for (int i = 0; i < nb_pts; ++i)
+	    count.Run(i);
+    firsts[0] = 0;
+    for (int i = 0; i < nb_pts; ++i)
+	firsts[i + 1] += firsts[i];
+
+    nb_segs = firsts[nb_pts];
+    if (nb_segs == 0) {
+	delete[] ptTan;
+	return;
+    }
+    segments = new Segment[nb_segs + 1];
+    TessellateTask tessellate(ptTan, &firsts[0], segments);
+    if (pool != 0)
+	pool->Run(tessellate, nb_pts);
+    else
+	for (int i = 0; i < nb_pts; ++i)
+	    tessellate.Run(i);
+    segments[nb_segs] = segments[0];
+
+    delete[] ptTan;
+
+    // Prefix sums of segment lengths, for logarithmic position lookups
+    offsets = new float[nb_segs + 1];
+    offsets[0] = 0.f;
+    for (int i = 0; i < nb_segs; ++i)
+	offsets[i + 1] = offsets[i] + segments[i].length;
+    totalLength = offsets[nb_segs];
+}
+
+Track::~Track()
+{
+    if (segments != 0)
+	delete[] segments;
+    if (offsets != 0)
+	delete[] offsets;
+}
+
+std::size_t Track::GetMemorySize() const
+{
+    // The first segment is repeated at the end
+    return nb_segs > 0 ? (nb_segs + 1) * (sizeof(Segment) + sizeof(float))
+		       : 0;
+}
+
+Basis Track::GetBasis(float position, int *hint) const
+{
+    const int cursor = FindSegment(position, hint);
+    const Segment &start = segments[cursor], &end = segments[cursor + 1];
+    float coef = position / start.length;
+    if (coef > 1.f)
+	coef = 1.f;
+
+    return Basis(start.origin * (1.f - coef) + end.origin * coef,
+		 Quaternion::Nlerp(start.rotation, end.rotation, coef));
+}
+
+// Lanes stored to an array of components, if any
+static inline void StoreLanes(float *const array, const int lanes,
+			      const Float4 &value)
+{
+    if (array == 0)
+	return;
+    if (lanes == 4)
+	value.StoreUnaligned(array);
+    else
+	for (int i = 0; i < lanes; ++i)
+	    array[i] = value.Get(i);
+}
+
+void Track::GetFrames(const float *const positions, const int count,
+		      float *const frames[FRAME_NUM], int *const hints) const
+{
+    int chain = -1;
+    for (int first = 0; first < count; first += 4) {
+	const int lanes = count - first < 4 ? count - first : 4;
+
+	// Segment lookups are scalar; missing lanes repeat the last position
+	const Segment *start[4];
+	float local[4];
+	for (int i = 0; i < 4; ++i) {
+	    const int index = first + (i < lanes ? i : lanes - 1);
+	    local[i] = positions[index];
+	    start[i] = &segments[FindSegment(local[i], hints != 0
+					     ? &hints[index] : &chain)];
+	}
+	const Segment *const end[4] = {
+	    start[0] + 1, start[1] + 1, start[2] + 1, start[3] + 1
+	};
+
+#define PODZ_GATHER(s, member) \
+    Float4(s[0]->member, s[1]->member, s[2]->member, s[3]->member)
+
+	// Blend of both neighbouring frames, as done by GetBasis and Basis,
+	// with the operations in the same order for the same results
+	const Float4 ratio = Float4(local[0], local[1], local[2], local[3])
+			   / PODZ_GATHER(start, length);
+	const Float4 coef = Min(ratio, Float4(1.f));
+	const Float4 ca = Float4(1.f) - coef;
+
+	const Float4 ax = PODZ_GATHER(start, rotation.x),
+		     ay = PODZ_GATHER(start, rotation.y),
+		     az = PODZ_GATHER(start, rotation.z),
+		     aw = PODZ_GATHER(start, rotation.w);
+	const Float4 bx = PODZ_GATHER(end, rotation.x),
+		     by = PODZ_GATHER(end, rotation.y),
+		     bz = PODZ_GATHER(end, rotation.z),
+		     bw = PODZ_GATHER(end, rotation.w);
+	const Float4 cb = Select(ax * bx + ay * by + az * bz + aw * bw
+				 < Float4(0.f), -coef, coef);
+	Float4 x = ax * ca + bx * cb, y = ay * ca + by * cb,
+	       z = az * ca + bz * cb, w = aw * ca + bw * cb;
+	const Float4 scale = Float4(1.f) / Sqrt(x * x + y * y + z * z + w * w);
+	x = x * scale, y = y * scale, z = z * scale, w = w * scale;
+
+	const Float4 x2 = x + x, y2 = y + y, z2 = z + z;
+	const Float4 xx = x * x2, yy = y * y2, zz = z * z2;
+	const Float4 xy = x * y2, xz = x * z2, yz = y * z2;
+	const Float4 wx = w * x2, wy = w * y2, wz = w * z2;
+
+	float *out[FRAME_NUM];
+	for (int i = 0; i < FRAME_NUM; ++i)
+	    out[i] = frames[i] != 0 ? frames[i] + first : 0;
+	StoreLanes(out[FRAME_ORIGIN_X], lanes,
+		   PODZ_GATHER(start, origin.x) * ca
+		   + PODZ_GATHER(end, origin.x) * coef);
+	StoreLanes(out[FRAME_ORIGIN_Y], lanes,
+		   PODZ_GATHER(start, origin.y) * ca
+		   + PODZ_GATHER(end, origin.y) * coef);
+	StoreLanes(out[FRAME_ORIGIN_Z], lanes,
+		   PODZ_GATHER(start, origin.z) * ca
+		   + PODZ_GATHER(end, origin.z) * coef);
+	StoreLanes(out[FRAME_RIGHT_X], lanes, Float4(1.f) - (yy + zz));
+	StoreLanes(out[FRAME_RIGHT_Y], lanes, xy + wz);
+	StoreLanes(out[FRAME_RIGHT_Z], lanes, xz - wy);
+	StoreLanes(out[FRAME_UP_X], lanes, xy - wz);
+	StoreLanes(out[FRAME_UP_Y], lanes, Float4(1.f) - (xx + zz));
+	StoreLanes(out[FRAME_UP_Z], lanes, yz + wx);
+	StoreLanes(out[FRAME_BACKWARD_X], lanes, xz + wy);
+	StoreLanes(out[FRAME_BACKWARD_Y], lanes, yz - wx);
+	StoreLanes(out[FRAME_BACKWARD_Z], lanes, Float4(1.f) - (xx + yy));
+
+	// The width blend is not clamped, like in GetWidth
+	StoreLanes(out[FRAME_WIDTH], lanes,
+		   PODZ_GATHER(start, width) * (Float4(1.f) - ratio)
+		   + PODZ_GATHER(end, width) * ratio);
+
+#undef PODZ_GATHER
+    }
+}
+
+float Track::GetWidth(float position, int *hint) const
+{
+    const int cursor = FindSegment(position, hint);
+    const float coef = position / segments[cursor].length;
+
+    return segments[cursor].width * (1.f - coef) +
+	   segments[cursor + 1].width * coef;
+}
+
+int Track::FindSegment(float &position, int *hint) const
+{
+    // Most positions are already within the lap
+    if (position < 0.f || position >= totalLength) {
+	position = fmodf(position, totalLength);
+	if (position < 0.f)
+	    position += totalLength;
+    }
+
+    int cursor;
+    if (hint != 0 && *hint >= 0 && *hint < nb_segs &&
+	position >= offsets[*hint]) {
+	// Most queries land in the same segment as the previous one or in the
+	// next one: check them before falling back to a binary search
+	cursor = *hint;
+	if (position >= offsets[cursor + 1] &&
+	    (++cursor == nb_segs || position >= offsets[cursor + 1]))
+	    cursor = -1;
+    } else
+	cursor = -1;
+
+    if (cursor < 0) {
+	cursor = static_cast<int>(std::upper_bound(offsets,
+						   offsets + nb_segs + 1,
+						   position) - offsets) - 1;
+	if (cursor >= nb_segs)
+	    cursor = nb_segs - 1;
+	else if (cursor < 0)
+	    cursor = 0;
+    }
+
+    if (hint != 0)
+	*hint = cursor;
+    position -= offsets[cursor];
+    return cursor;
+}
+
+void Track::GetSection(const int index, Vector points[4]) const
+{
+    const Basis frame = GetFrame(index);
+    const Vector top = frame.up * BORDER_HEIGHT;
+
+    points[1] = frame.origin - frame.right * (CIRC_WIDTH * .5f);
+    points[2] = frame.origin + frame.right * (CIRC_WIDTH * .5f);
+    points[0] = points[1] - frame.right * BORDER_WIDTH + top;
+    points[3] = points[2] + frame.right * BORDER_WIDTH + top;
+}
+
+float Track::GetBorderSlope()
+{
+    return BORDER_WIDTH / BORDER_HEIGHT;
+}
+
+float Track::GetBorderWidth()
+{
+    return BORDER_WIDTH;
+}
+
+float Track::GetBorderHeight()
+{
+    return BORDER_HEIGHT;
+}
+
+int Track::Tessellate(const Point &start, const Point &end,
+		      Segment *const segs)
+{
+    const float chord = (end.point - start.point).Length();
+    if (chord <= 0.f)
+	return 0;
+
+    return Tessellate(Curve(start, end, chord), 0.f, 1.f, 0, segs);
+}
+
+// Segments between both curve parameters, written from the given one unless
+// it is null: the count is the same both ways
+int Track::Tessellate(const Curve &curve, const float t0, const float t1,
+		      const int depth, Segment *const segs)
+{
+    const Vector start = curve.GetPoint(t0), end = curve.GetPoint(t1);
+    const Vector chord = end - start;
+    const float length = chord.Length();
+    const float middle = (t0 + t1) * .5f;
+
+    if (depth < MAX_DEPTH &&
+	(length > MAX_SEG_LENGTH ||
+	 (curve.GetPoint(middle) - (start + end) * .5f).Length() > MAX_ERROR ||
+	 Turns(curve.GetTangent(t0), curve.GetTangent(t1)) ||
+	 Turns(curve.GetNormal(t0), curve.GetNormal(t1)))) {
+	const int first = Tessellate(curve, t0, middle, depth + 1, segs);
+	return first + Tessellate(curve, middle, t1, depth + 1,
+				  segs != 0 ? segs + first : 0);
+    }
+
+    if (segs != 0) {
+	const Segment newseg = {
+	    start, Basis(start, chord, curve.GetNormal(t0)).GetRotation(),
+	    length, CIRC_WIDTH
+	};
+	*segs = newseg;
+    }
+    return 1;
+}
+
+} // namespace Podz
+
+// End of File
@@ -0,0 +1,134 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Track.h
+ * Description: Circuit Geometry and Track Frame Queries (Header)
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+#ifndef PODZ_TRACK_H
+#define PODZ_TRACK_H
+
+// STL
+#include <vector>
+
+// This module
+#include "Vector.h"
+#include "Quaternion.h"
+#include "Basis.h"
+
+
+namespace Podz {
+
+class ThreadPool;
+
+// Circuit geometry, without any rendering: this is all the physics needs
+class Track
+{
+public:
+    // Components of a frame, for the batched queries
+    enum Frame {
+	FRAME_ORIGIN_X = 0, FRAME_ORIGIN_Y, FRAME_ORIGIN_Z,
+	FRAME_RIGHT_X, FRAME_RIGHT_Y, FRAME_RIGHT_Z,
+	FRAME_UP_X, FRAME_UP_Y, FRAME_UP_Z,
+	FRAME_BACKWARD_X, FRAME_BACKWARD_Y, FRAME_BACKWARD_Z,
+	FRAME_WIDTH,
+	FRAME_NUM
+    };
+
+    // Spans between control points are tessellated in parallel on the pool,
+    // if any
+    Track(const char *const filename, ThreadPool *const pool = 0);
+    ~Track();
+
+    bool IsLoaded() const { return nb_segs != 0; };
+    float GetTotalLength() const { return totalLength; }
+    int GetSegmentCount() const { return nb_segs; }
+    std::size_t GetMemorySize() const; // Of the segments, in bytes
+
+    // The optional hint is a segment cursor kept by the caller between
+    // queries: lookups near the previous one are then done in constant time
+    Basis GetBasis(float position, int *hint = 0) const;
+    float GetWidth(float position, int *hint = 0) const;
+
+    // The same as GetBasis and GetWidth, for many positions at once, four at
+    // a time: every component goes to its own array of one float per
+    // position, unless its array is null.  Hints are one per position;
+    // without them, each lookup starts from the previous one, which is fast
+    // when the positions are sorted
+    void GetFrames(const float *const positions, const int count,
+		   float *const frames[FRAME_NUM], int *const hints = 0) const;
+    static float GetBorderSlope();
+    static float GetBorderWidth();
+    static float GetBorderHeight();
+
+protected:
+    // Only what the per-tick lookups read, to fit two segments in a cache
+    // line or so: the render geometry derives from the frame when needed
+    struct Segment {
+	Vector origin;
+	Quaternion rotation;
+	float length, width;
+    };
+
+    int nb_segs;
+    Segment *segments;
+
+    Basis GetFrame(const int index) const
+	{ return Basis(segments[index].origin, segments[index].rotation); }
+
+    // Cross-section at the start of a segment, from the outer edge of the
+    // left border to the one of the right border
+    void GetSection(const int index, Vector points[4]) const;
+
+private:
+    struct Point {
+	Vector point, normal, tangent;
+    };
+
+    float *offsets; // Arc-length at the start of each segment
+    float totalLength;
+
+    struct Curve;
+    class CountTask;
+    class TessellateTask;
+
+    int FindSegment(float &position, int *hint) const;
+    static int Tessellate(const Point &start, const Point &end,
+			  Segment *const segs);
+    static int Tessellate(const Curve &curve, const float t0, const float t1,
+			  const int depth, Segment *const segs);
+
+    // No copy
+    Track(const Track &);
+    void operator =(const Track &) const;
+};
+
+} // namespace Podz
+
+#endif // !PODZ_TRACK_H
+
+// End of File
@@ -38,14 +38,17 @@
 #include <cmath>
 
 // This module
+#include "Numeric.h"
 #include "Vector.h"
 
 namespace Podz {
 
 Vector &Vector::Rotate(float rx, float ry, float rz)
 {
-    const float sin_rx = sinf(rx), sin_ry = sinf(ry), sin_rz = sinf(rz);
-    const float cos_rx = cosf(rx), cos_ry = cosf(ry), cos_rz = cosf(rz);
+    const float sin_rx = Numeric::Sin(rx), sin_ry = Numeric::Sin(ry),
+		sin_rz = Numeric::Sin(rz);
+    const float cos_rx = Numeric::Cos(rx), cos_ry = Numeric::Cos(ry),
+		cos_rz = Numeric::Cos(rz);
 
     if (rx != 0.f) {
 	const float y2 = y * cos_rx - z * sin_rx;
@@ -66,13 +69,6 @@ Vector &Vector::Rotate(float rx, float ry, float rz)
     return *this;
 }
 
-Vector Vector::VectorProduct(const Vector &p) const
-{
-    return Vector(y * p.z - z * p.y,
-		  z * p.x - x * p.z,
-		  x * p.y - y * p.x);
-}
-
 float Vector::Length() const
 {
     return sqrtf(x * x + y * y + z * z);
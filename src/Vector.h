@@ -40,17 +40,15 @@ public:
     // Coordinates
     float x, y, z;
 
-    // Constructor
+    // Constructor; copies and assignments are the implicit ones, so that
+    // vectors are trivially copyable and can live in registers
     Vector(float vx = 0.f, float vy = 0.f, float vz = 0.f)
         : x(vx), y(vy), z(vz) {}
 
-    // Assignment operator and copy constructor
+    // Assignment
     Vector &Set(const float vx = 0.f, const float vy = 0.f,
                 const float vz = 0.f)
         { x = vx, y = vy, z = vz; return *this; }
-    Vector &operator =(const Vector &v)
-        { x = v.x, y = v.y, z = v.z; return *this; }
-    Vector(const Vector &v) { (*this) = v; }
 
     // Geometric transformations
     Vector &Add(const float tx, const float ty, const float tz)
@@ -66,8 +64,18 @@ public:
     Vector &Rotate(const float rx, const float ry, const float rz);
     Vector &Rotate(const Vector &r) { return Rotate(r.x, r.y, r.z); }
 
+    // Fused t * s addition, without an intermediate vector
+    Vector &AddScaled(const Vector &t, const float s)
+        { x += t.x * s, y += t.y * s, z += t.z * s; return *this; }
+
     // Scalar product (new vector)
-    Vector VectorProduct(const Vector &p) const;
+    Vector VectorProduct(const Vector &p) const
+        { return Vector(y * p.z - z * p.y, z * p.x - x * p.z,
+                        x * p.y - y * p.x); }
+
+    // Dot product
+    float DotProduct(const Vector &p) const
+        { return x * p.x + y * p.y + z * p.z; }
 
     // Vector length
     float Length() const;
@@ -76,24 +84,30 @@ public:
     Vector &Reverse() { x = -x, y = -y, z = -z; return *this; }
     Vector &Normalize(const float n = 1.f) { return Scale(n / Length()); }
 
-    // Addition/substraction operators
+    // Addition/substraction operators: the results are built directly,
+    // component by component
     Vector &operator +=(const Vector &t) { return Add(t); }
     Vector &operator -=(const Vector &t) { return Sub(t); }
-    Vector operator +(const Vector &t) const { return Vector(*this) += t; }
-    Vector operator -(const Vector &t) const { return Vector(*this) -= t; }
+    Vector operator +(const Vector &t) const
+        { return Vector(x + t.x, y + t.y, z + t.z); }
+    Vector operator -(const Vector &t) const
+        { return Vector(x - t.x, y - t.y, z - t.z); }
 
-    // Scaling operators
+    // Scaling operators; a division multiplies by the inverse, as it
+    // always did, not to change results
     Vector &operator *=(const float s) { return Scale(s); }
     Vector &operator /=(const float s) { return Scale(1.f / s); }
-    Vector operator *(const float s) const { return Vector(*this) *= s; }
-    Vector operator /(const float s) const { return Vector(*this) /= s; }
+    Vector operator *(const float s) const
+        { return Vector(x * s, y * s, z * s); }
+    Vector operator /(const float s) const
+        { const float r = 1.f / s; return Vector(x * r, y * r, z * r); }
 
     // Scalar product operators
     Vector operator *(const Vector &p) const { return VectorProduct(p); }
-    Vector &operator *=(const Vector &p) { return (*this) *= p; }
+    Vector &operator *=(const Vector &p) { return *this = VectorProduct(p); }
 
     // Miscellaneous operators
-    Vector operator -() const { return Vector(*this).Reverse(); }
+    Vector operator -() const { return Vector(-x, -y, -z); }
     Vector &operator %=(const float n) { return Normalize(n); }
     Vector operator %(const float n) const { return Vector(*this) %= n; }
 
@@ -54,63 +54,65 @@
 #include "Vector.h"
 #include "Basis.h"
 #include "Texture.h"
+#include "Track.h"
 #include "Circuit.h"
 #include "Display.h"
 #include "Timer.h"
+#include "LapSplits.h"
 #include "Vehicle.h"
 
 
 namespace Podz {
 
-static const float LEVIT_HEIGHT = .3f;
-static const float INERTY = .995f;
-static const float ACCEL = .000005f;
-static const float ROT_ANGLE = .025f;
-static const float MAX_ACCEL = .0015f;
-static const float GRAVITY = .001f;
-static const float BORDER = .1f;
-static const float GROUND_REACTION_TOUCH_FACTOR = 1.5f;
-static const float GROUND_REACTION_FACTOR = 1.f;
-static const float GROUND_REACTION_MAX = 4.f * GRAVITY;
-static const float GROUND_REACTION_HEIGHT_MAX = LEVIT_HEIGHT * 3.f;
-static const float REACTION_FACTOR = .5f;
-static const float REACTION_SPEED_FACTOR = 4.f;
-static const float REACTION_MIN = 1.f;
-
-static const float SLOPE_INCREASE = .02f;
-static const float SLOPE_DECREASE_FACTOR = .97f;
-static const float SLOPE_MAX = static_cast<float>(M_PI) / 3.f;
 static const float SLOPE_OFFSET_FACTOR = .5f;
 
-static const int LAP_NUM = 3;
+Texture *Vehicle::textures[TEX_NUM];
+int Vehicle::instances = 0;
 
-Vehicle::Vehicle(Circuit &circ)
-    : circuit(circ), timer(0)
+Vehicle::Vehicle(Circuit &circ, const bool plyr)
+    : Pod(circ), timer(0), splits(0), player(plyr)
 {
     static const char *const files[TEX_NUM] = {
 	"cockpit", "gray-red", "gray", "back", "top-right", "top-left", "grid"
     };
 
-    for (int i = 0; i < TEX_NUM; ++i)
-	textures[i] = new Texture(files[i]);
+    if (instances++ == 0) {
+	for (int i = 0; i < TEX_NUM; ++i)
+	    textures[i] = new Texture(files[i]);
+    }
 
     Init();
 }
 
+Vehicle::~Vehicle()
+{
+    if (--instances == 0) {
+	for (int i = 0; i < TEX_NUM; ++i)
+	    delete textures[i];
+    }
+}
+
 void Vehicle::SetupModelview()
 {
+    Interpolate();
+    if (!player)
+	return;
+
     glLoadIdentity();
-    const Vector eye = position - (direction * 1.5f);
-    const Vector up = basis.backward
-		    * Vector(basis.right.x, 0.f, basis.right.z);
-    glTranslatef(slope * SLOPE_OFFSET_FACTOR, -.6f, 0.f);
+    const Vector eye = viewPosition - (viewDirection * 1.5f);
+    const Vector up = viewBasis.backward
+		    * Vector(viewBasis.right.x, 0.f, viewBasis.right.z);
+    glTranslatef(viewSlope * SLOPE_OFFSET_FACTOR, -.6f, 0.f);
     gluLookAt(eye.x, eye.y, eye.z,
-	      position.x, position.y, position.z,
+	      viewPosition.x, viewPosition.y, viewPosition.z,
 	      up.x, up.y, up.z);
 }
 
 void Vehicle::SetupLightsConst()
 {
+    if (!player)
+	return;
+
     glPushMatrix();
     glLoadIdentity();
     glTranslatef(0.f, -.5f, -1.8f);
@@ -164,9 +166,9 @@ void Vehicle::DisplayVar()
     // on sauvegarde la matrice
     glPushMatrix();
 
-    Basis(position, direction, basis.up).Move();
+    MoveTo(Basis(viewPosition, viewDirection, viewBasis.up));
     glTranslatef(0.f, .075f, -.55f);
-    glRotatef(slope * (180.f / static_cast<float>(M_PI)), 0.f, 0.f, 1.f);
+    glRotatef(viewSlope * (180.f / static_cast<float>(M_PI)), 0.f, 0.f, 1.f);
 
     // type d'affichage
     glPolygonMode(GL_FRONT, GL_FILL);
@@ -368,12 +370,14 @@ void Vehicle::DisplayVar()
     DrawTriangle(point11, point36, point10, textures[0], 0);
 
     // reacteur droit
+    GLUquadricObj *const quadric = gluNewQuadric();
     glTranslatef(.09f, .07f, 1.f);
-    gluCylinder(gluNewQuadric(), .05, .07, .07, 50, 1);
+    gluCylinder(quadric, .05, .07, .07, 50, 1);
 
     // reacteur gauche
     glTranslatef(-.18f, 0.f, 0.f);
-    gluCylinder(gluNewQuadric(), .05, .07, .07, 50, 1);
+    gluCylinder(quadric, .05, .07, .07, 50, 1);
+    gluDeleteQuadric(quadric);
 
     // on remet la matrice
     glPopMatrix();
@@ -381,155 +385,71 @@ void Vehicle::DisplayVar()
 
 void Vehicle::DisplayOSD()
 {
+    if (!player)
+	return;
+
     char buffer[32];
 
     if (lap <= LAP_NUM) {
 	// Fake speed value ;)
 	snprintf(buffer, sizeof(buffer), "Speed: %d km/h",
-		 static_cast<int>(speed.Length() * 666.f));
+		 static_cast<int>(speed.Length() * 6.66f));
 	Display::DisplayText(buffer, .1f, .5f);
 
 	snprintf(buffer, sizeof(buffer), "Lap %d/%d", lap, LAP_NUM);
 	Display::DisplayText(buffer, -.72f, .5f);
 
+	// Ahead of the best lap (negative) or behind it
+	double delta;
+	if (splits != 0 && splits->GetDelta(delta)) {
+	    snprintf(buffer, sizeof(buffer), "Best %+.2f s", delta);
+	    Display::DisplayText(buffer, .1f, .4f);
+	}
+
 	if (wrongWay)
 	    Display::DisplayText("WRONG WAY!",-.63f, 0.f, .0015f);
     }
 
     snprintf(buffer, sizeof(buffer), "Done: %d%%",
 	     static_cast<int>(circPosition /
-		     (circuit.GetTotalLength() * LAP_NUM) * 100.f));
+		     (track.GetTotalLength() * LAP_NUM) * 100.f));
     Display::DisplayText(buffer, .3f, -.5f);
 }
 
 void Vehicle::Init()
 {
-    basis = circuit.GetBasis(0.f);
-    position = basis.origin + basis.up * LEVIT_HEIGHT / 2.f;
-    direction = -basis.backward;
-    speed.Set(0.f, 0.f, 0.f);
-    circPosition = 0.f;
-    lapPosition = 0.f;
-    circOffset = 0.f;
-    acceleration = 0.f;
-    angle = 0.f;
-    slope = 0.f;
-
-    accelerated = false;
-    wrongWay = false;
-    lap = 1;
-}
-
-void Vehicle::Move()
-{
-    const Vector localpos = basis.RevertPoint(position);
-    const Vector localspeed = basis.RevertVector(speed);
-
-    direction = basis.TransformVector(Vector(0.f, 0.f, -1.f)
-		.Rotate(0.f, angle, 0.f));
-
-    speed = speed * (INERTY) + direction * acceleration
-	    + Vector(0.f, -GRAVITY, 0.f);
-
-    float ground = 0.f;
-    if (localpos.y < 0) {
-	position += basis.up * -localpos.y;
-	ground = localspeed.y * -GROUND_REACTION_TOUCH_FACTOR;
-    } else if (localpos.y < GROUND_REACTION_HEIGHT_MAX) {
-	const float height = LEVIT_HEIGHT / GROUND_REACTION_FACTOR;
-	if (localpos.y <= height)
-	    ground = GROUND_REACTION_MAX - localpos.y * ((GROUND_REACTION_MAX
-		    - GRAVITY) / height);
-	else
-	    ground = GRAVITY - (localpos.y - height) * (GRAVITY /
-		    (GROUND_REACTION_HEIGHT_MAX - height));
-	ground *= GROUND_REACTION_FACTOR;
-    }
-    speed += basis.up * ground;
-
-    const float diff = fabsf(localpos.x)
-		     - (circuit.GetWidth(circPosition) * .5f
-			+ circuit.GetBorderSlope() * localpos.y - BORDER);
-    if (diff > 0) {
-	position += basis.right * (2.f * (localpos.x < 0 ? diff : -diff));
-	const float min = REACTION_MIN * speed.Length();
-	float reaction = localspeed.x * -REACTION_FACTOR;
-	if (fabsf(reaction) < min)
-	    reaction = localspeed.x < 0 ? min : -min;
-	speed *= REACTION_SPEED_FACTOR * fabsf(localspeed.x);
-	speed += basis.right * reaction * REACTION_FACTOR;
-	acceleration *= .5f;
-    }
-
-    position += speed;
-    if (accelerated)
-	accelerated = false;
-    else
-	Decelerate(ACCEL / 2.f);
-    slope *= SLOPE_DECREASE_FACTOR;
-
-    const Vector newpos = basis.RevertPoint(position);
-    circOffset += newpos.x;
-    if (newpos.z != 0.f) {
-	const float circAdd = -basis.RevertPoint(position).z;
-	wrongWay = circAdd < -.001f;
-	circPosition += circAdd;
-	lapPosition += circAdd;
-
-	const Vector oldright = basis.right;
-	basis = circuit.GetBasis(circPosition);
-
-	const Vector newright = basis.RevertVector(oldright);
-	if (newright.x < 1.f) {
-	    if (newright.z > 0.f)
-		angle += acosf(newright.x);
-	    else if (newright.z < 0.f)
-		angle -= acosf(newright.x);
-	}
-    } else
-	wrongWay = false;
-
-    if (lapPosition >= circuit.GetTotalLength()) {
-	lapPosition -= circuit.GetTotalLength();
-	if (++lap > LAP_NUM)
-	    timer->Finish();
-    }
+    Pod::Init();
+    SaveState();
 }
 
-void Vehicle::Accelerate()
+void Vehicle::BeginStep()
 {
-    accelerated = true;
-    acceleration += ACCEL;
-    if (acceleration > MAX_ACCEL)
-	acceleration = MAX_ACCEL;
+    SaveState();
 }
 
-void Vehicle::Brake()
+void Vehicle::Restore(const State &state)
 {
-    Decelerate(ACCEL * 4.f);
+    Pod::Restore(state);
+    SaveState();
 }
 
-void Vehicle::TurnLeft()
+void Vehicle::SaveState()
 {
-    angle -= ROT_ANGLE;
-    if ((slope += SLOPE_INCREASE) > SLOPE_MAX)
-	slope = SLOPE_MAX;
+    prevBasis = basis;
+    prevPosition = position;
+    prevDirection = direction;
+    prevSlope = slope;
 }
 
-void Vehicle::TurnRight()
+void Vehicle::Interpolate()
 {
-    angle += ROT_ANGLE;
-    if ((slope -= SLOPE_INCREASE) < -SLOPE_MAX)
-	slope = -SLOPE_MAX;
-}
+    const float alpha = timer != 0 ? timer->GetInterpolation() : 1.f;
 
-void Vehicle::Decelerate(const float amount)
-{
-    if (acceleration > 0.f) {
-	acceleration -= amount;
-	if (acceleration < 0.f)
-	    acceleration = 0.f;
-    }
+    viewBasis = prevBasis.Merge(basis, alpha);
+    viewPosition = prevPosition + (position - prevPosition) * alpha;
+    viewDirection = (prevDirection + (direction - prevDirection) * alpha)
+		  % 1.f;
+    viewSlope = prevSlope + (slope - prevSlope) * alpha;
 }
 
 } // namespace Podz
@@ -35,6 +35,7 @@
 #include "Object.h"
 #include "Vector.h"
 #include "Basis.h"
+#include "Pod.h"
 
 namespace Podz
 {
@@ -42,47 +43,45 @@ namespace Podz
 class Circuit;
 class Texture;
 class Timer;
+class LapSplits;
 
-class Vehicle : public Object
+class Vehicle : public Object, public Pod
 {
 public:
-    Vehicle(Circuit &circ);
+    // Only the player vehicle holds the camera, headlights and OSD
+    Vehicle(Circuit &circ, const bool plyr = true);
+    virtual ~Vehicle();
 
     virtual void SetupModelview();
     virtual void SetupLightsConst();
     virtual void DisplayVar();
     virtual void DisplayOSD();
 
+    // Same as the Pod ones, keeping track of the state to interpolate from
     void Init();
-    void Move();
-    void Accelerate();
-    void Brake();
-    void TurnLeft();
-    void TurnRight();
+    void Restore(const State &state);
 
     void SetTimer(Timer *const tmr) { timer = tmr; }
+    void SetSplits(const LapSplits *const spl) { splits = spl; }
 
 private:
-    Circuit &circuit;
     Timer *timer;
+    const LapSplits *splits;
+    bool player;
 
+    // Shared by all the vehicles
     enum { TEX_NUM = 7 };
-    Texture *textures[TEX_NUM];
-
-    Basis basis;
-    Vector position, direction;
-    Vector speed;
-    float circPosition, lapPosition;
-    float circOffset;
-    float acceleration;
-    float angle;
-    float slope;
-
-    bool accelerated;
-    bool wrongWay;
-    int lap;
-
-    void Decelerate(const float amount);
+    static Texture *textures[TEX_NUM];
+    static int instances;
+
+    // State before the last step, and state interpolated for rendering
+    Basis prevBasis, viewBasis;
+    Vector prevPosition, prevDirection, viewPosition, viewDirection;
+    float prevSlope, viewSlope;
+
+    void BeginStep();
+    void SaveState();
+    void Interpolate();
 
     // No assignment
     void operator =(const Vehicle &) const;
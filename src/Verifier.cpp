@@ -0,0 +1,324 @@
+/*
+ * ---------------------------------------------------------------------------
+ *
+ * Podz: A Pod Racing Game
+ * Copyright (C) 2006-2018 Benjamin Gaillard & Nicolas Riegel
+ *
+ * ---------------------------------------------------------------------------
+ *
+ *        File: src/Verifier.cpp
+ * Description: Lap Time Verification Program
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 59
+ * Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * ---------------------------------------------------------------------------
+ */
+
+
+// Configuration
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+// Windows
+#ifdef _WIN32
+# define DIRSEP "\\"
+#else // !_WIN32
+# define DIRSEP "/"
+#endif // !_WIN32
+
+// STL
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// System
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+// This module
+#include "Clock.h"
+#include "Track.h"
+#include "Pod.h"
+#include "Pilot.h"
+#include "Race.h"
+#include "Replay.h"
+#include "RacingLine.h"
+#include "ThreadPool.h"
+
+
+namespace Podz {
+
+// One submitted run: a replay of the player inputs, and the lap times it
+// claims, in seconds
+struct Submission {
+    std::string file;
+    std::vector<double> claims;
+
+    // Verification result
+    bool loaded, finished;
+    int rate;
+    std::vector<int> laps; // In ticks
+    std::string error;
+};
+
+// Manifest lines are "<replay> [<lap time> ...]"; '#' starts a comment
+static bool LoadManifest(std::istream &manifest, std::vector<Submission> &runs)
+{
+    std::string line;
+    while (std::getline(manifest, line)) {
+	const std::string::size_type comment = line.find('#');
+	if (comment != std::string::npos)
+	    line.erase(comment);
+
+	std::istringstream stream(line);
+	Submission run;
+	if (!(stream >> run.file))
+	    continue;
+	double claim;
+	while (stream >> claim)
+	    run.claims.push_back(claim);
+	if (!stream.eof())
+	    return false;
+
+	run.loaded = run.finished = false;
+	run.rate = 0;
+	runs.push_back(run);
+    }
+
+    return true;
+}
+
+// Simulates every run again, on its own, with the same opponents as when
+// it was recorded
+class VerifyTask : public ThreadPool::Task
+{
+public:
+    VerifyTask(const Track &trk, const RacingLine &line, const unsigned hash,
+	       std::vector<Submission> &rns)
+	: track(trk), racing(line), levelHash(hash), runs(rns) {}
+
+    virtual void Run(const int index)
+    {
+	Verify(runs[index]);
+    }
+
+private:
+    const Track &track;
+    const RacingLine &racing;
+    const unsigned levelHash;
+    std::vector<Submission> &runs;
+
+    void Verify(Submission &run) const;
+
+    void operator =(const VerifyTask &) const;
+};
+
+void VerifyTask::Verify(Submission &run) const
+{
+    Replay replay;
+    // Loading checks that the submitter did not choose the physics step
+    // nor the race size beyond what the game allows
+    if (!replay.Load(run.file.c_str())) {
+	run.error = Replay::GetErrorString(replay.GetError());
+	return;
+    }
+    if (replay.GetLevelHash() != levelHash) {
+	run.error = "recorded on another level";
+	return;
+    }
+    run.loaded = true;
+    run.rate = replay.GetRate();
+
+    Race race(track);
+    std::vector<Pod *> pods(replay.GetOpponents() + 1);
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i) {
+	pods[i] = new Pod(track);
+	race.AddPod(*pods[i], i == 0 ? 0 :
+		    Pilot::CreateOpponent(track, static_cast<int>(i) - 1,
+					  &racing));
+    }
+
+    // Replays may hold up to INT_MAX ticks: races slower than the game
+    // allows are given up, not to hold a worker that long
+    const float dt = 1.f / static_cast<float>(run.rate);
+    const int maxTicks = Pod::LAP_NUM * Pod::MAX_LAP_TIME * run.rate;
+    const Pod &player = *pods[0];
+    int lap = player.GetLap(), lapStart = 0;
+    unsigned input;
+    while (!player.HasFinished() && race.GetTick() < maxTicks &&
+	   replay.Play(input)) {
+	race.SetInput(0, input);
+	race.Step(dt);
+	if (player.GetLap() != lap) {
+	    lap = player.GetLap();
+	    run.laps.push_back(race.GetTick() - lapStart);
+	    lapStart = race.GetTick();
+	}
+    }
+    run.finished = player.HasFinished();
+
+    const bool timedOut = !run.finished && race.GetTick() == maxTicks;
+
+    for (std::vector<Pod *>::size_type i = 0; i < pods.size(); ++i)
+	delete pods[i];
+
+    if (timedOut) {
+	std::ostringstream message;
+	message << "did not finish within "
+		<< Pod::LAP_NUM * Pod::MAX_LAP_TIME << " s";
+	run.error = message.str();
+	return;
+    }
+
+    // Claims must match the simulation within half a tick
+    if (run.claims.size() > run.laps.size()) {
+	run.error = "fewer laps than claimed";
+	return;
+    }
+    for (std::vector<double>::size_type i = 0; i < run.claims.size(); ++i) {
+	const double time = static_cast<double>(run.laps[i]) / run.rate;
+	if (fabs(run.claims[i] - time) >= .5 / run.rate) {
+	    std::ostringstream message;
+	    message << "lap " << i + 1 << " claimed " << run.claims[i]
+		    << " s, simulated " << time << " s";
+	    run.error = message.str();
+	    return;
+	}
+    }
+}
+
+static int Usage(const char *const name)
+{
+    std::cerr << "Usage: " << name
+	      << " [-j THREADS] [-l LEVEL] [MANIFEST]" << std::endl;
+    return EXIT_FAILURE;
+}
+
+static int Verify(int argc, char **argv)
+{
+    int threads = 0;
+    const char *level = 0, *manifestFile = 0;
+
+    for (int i = 1; i < argc; ++i) {
+	if (argv[i][0] != '-' && manifestFile == 0)
+	    manifestFile = argv[i];
+	else if (i + 1 >= argc)
+	    return Usage(argv[0]);
+	else if (std::strcmp(argv[i], "-j") == 0)
+	    threads = std::atoi(argv[++i]);
+	else if (std::strcmp(argv[i], "-l") == 0)
+	    level = argv[++i];
+	else
+	    return Usage(argv[0]);
+    }
+    if (threads < 0)
+	return Usage(argv[0]);
+
+    // Manifest: from the given file, or the standard input
+    std::vector<Submission> runs;
+    bool loaded;
+    if (manifestFile != 0) {
+	std::ifstream manifest(manifestFile);
+	loaded = manifest.is_open() && LoadManifest(manifest, runs);
+    } else
+	loaded = LoadManifest(std::cin, runs);
+    if (!loaded) {
+	std::cerr << "Error: could not load manifest '"
+		  << (manifestFile != 0 ? manifestFile : "-") << "'."
+		  << std::endl;
+	return EXIT_FAILURE;
+    }
+
+    // Default level: look in the same places as the game does
+    static const char *const levels[] = {
+#ifdef DATA_DIR
+	DATA_DIR DIRSEP "level.txt",
+#endif // DATA_DIR
+	"data" DIRSEP "level.txt", ".." DIRSEP "data" DIRSEP "level.txt"
+    };
+    ThreadPool pool(threads);
+    Track *track = 0;
+    if (level != 0)
+	track = new Track(level, &pool);
+    else {
+	for (unsigned i = 0; i < sizeof(levels) / sizeof(*levels); ++i) {
+	    delete track;
+	    track = new Track(level = levels[i], &pool);
+	    if (track->IsLoaded())
+		break;
+	}
+    }
+    unsigned levelHash = 0;
+    if (!track->IsLoaded() || !Replay::HashLevel(level, levelHash)) {
+	std::cerr << "Error: could not load level '" << level << "'."
+		  << std::endl;
+	delete track;
+	return EXIT_FAILURE;
+    }
+
+    RacingLine racing(*track);
+    racing.Load(RacingLine::GetFileName(level).c_str());
+    VerifyTask task(*track, racing, levelHash, runs);
+    const double start = Clock::GetTime();
+    pool.Run(task, static_cast<int>(runs.size()));
+    const double elapsed = Clock::GetTime() - start;
+
+    // One line per run, in the manifest order: verified runs with their lap
+    // times, runs without claims with their simulated times
+    int rejected = 0, laps = 0;
+    std::cout.setf(std::ios::fixed);
+    for (std::vector<Submission>::size_type i = 0; i < runs.size(); ++i) {
+	const Submission &run = runs[i];
+	laps += static_cast<int>(run.laps.size());
+	if (!run.error.empty()) {
+	    std::cout << run.file << ": REJECTED (" << run.error << ")\n";
+	    ++rejected;
+	    continue;
+	}
+
+	// Enough decimals to tell ticks apart
+	std::cout.precision(static_cast<int>(ceil(log10(
+	    static_cast<double>(run.rate)))));
+	std::cout << run.file << (run.claims.empty() ? ": TIMED" :
+				  ": VERIFIED");
+	for (std::vector<int>::size_type j = 0; j < run.laps.size(); ++j)
+	    std::cout << ' ' << static_cast<double>(run.laps[j]) / run.rate;
+	std::cout << (run.finished ? "\n" : " (unfinished)\n");
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(6);
+    std::cerr << runs.size() << " runs, " << rejected << " rejected, "
+	      << laps << " laps simulated in " << elapsed << " s on "
+	      << pool.GetThreadCount() << " threads" << std::endl;
+
+    delete track;
+    return rejected == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace Podz
+
+
+extern "C" int main(int argc, char **argv)
+{
+    return Podz::Verify(argc, argv);
+}
+
+// End of File